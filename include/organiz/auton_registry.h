@@ -0,0 +1,59 @@
+#ifndef ROBOT_AUTON_REGISTRY
+#define ROBOT_AUTON_REGISTRY
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// Every auton with what it's for, in one constant table (src/autons.cpp)
+// that the compiler lays out, so listing them at startup allocates nothing.
+// The brain's selector (include/organiz/auton_select.h), the selection
+// saved on the SD card and the sim's runs all go through it.
+
+enum class Alliance : uint8_t { NONE, RED, BLUE };
+enum class AutonSide : uint8_t { NONE, RING, GOAL, SKILLS };
+
+struct AutonInfo {
+    const char* name;
+    void (*fn)();
+    Alliance alliance = Alliance::NONE;
+    AutonSide side = AutonSide::NONE;
+    uint16_t expected_ms = 0;     // what `./bin/sim` takes, 0 if it's not timed
+    const char* description = ""; // lines under the name, split by '\n'
+};
+
+const char* alliance_name(Alliance alliance);
+const char* auton_side_name(AutonSide side);
+
+constexpr bool name_equal(const char* a, const char* b) {
+    while (*a != '\0' && *a == *b) {
+        a++;
+        b++;
+    }
+    return *a == *b;
+}
+
+// Names have to be unique, and each blue match auton needs a red one for
+// the same side, its mirror()
+template <size_t N>
+constexpr bool auton_registry_valid(const AutonInfo (&autons)[N]) {
+    for (size_t i = 0; i < N; i++) {
+        if (autons[i].fn == nullptr) return false;
+        bool twin = autons[i].alliance != Alliance::BLUE;
+        for (size_t j = 0; j < N; j++) {
+            if (i != j && name_equal(autons[i].name, autons[j].name)) return false;
+            if (autons[i].alliance == Alliance::BLUE && autons[j].alliance == Alliance::RED && autons[i].side == autons[j].side)
+                twin = true;
+        }
+        if (!twin) return false;
+    }
+    return true;
+}
+
+extern const std::span<const AutonInfo> auton_registry;
+
+// Index of the auton named name, -1 if there isn't one
+int auton_find(const char* name);
+// The other alliance's auton for the same side, -1 if there isn't one
+int auton_mirror(int index);
+
+#endif //ROBOT_AUTON_REGISTRY
@@ -0,0 +1,25 @@
+#ifndef ROBOT_AUTON_SELECT
+#define ROBOT_AUTON_SELECT
+#include "main.h"
+#include "auton_registry.h"
+
+// Picking the auton on the brain, in place of EZ's ez::as selector, which
+// copies every name into a std::string and the list into a vector. The
+// LLEMU left and right buttons step through auton_registry, the screen
+// shows the pick through the ui queue (include/organiz/controller_io.h),
+// and the name is saved to AUTON_SELECT_PATH, so a reboot between matches
+// keeps it and a reordered list can't pick the wrong one.
+
+const char* const AUTON_SELECT_PATH = "/usd/auton.txt";
+
+// Loads the saved pick, shows it and takes the LLEMU buttons
+void auton_select_init();
+
+void auton_select(int index);
+int auton_selected_index();
+const AutonInfo& auton_selected();
+
+// Runs the pick, from autonomous()
+void auton_selected_run();
+
+#endif //ROBOT_AUTON_SELECT
@@ -0,0 +1,51 @@
+#ifndef ROBOT_AUTOTUNE
+#define ROBOT_AUTOTUNE
+#include "main.h"
+#include "relay_tune.h"
+
+// Automatic tuning for EZ's turn, forward drive and swing PIDs. A relay
+// experiment (include/organiz/relay_tune.h) rocks the robot around where it
+// is, and each tuning rule's gains are then tried on a real move. A
+// candidate passes if every move ends inside the loop's small exit error,
+// so EZ let go on the small exit condition and not on a timeout. The
+// fastest passing candidate is suggested, but nothing is kept until it's
+// picked.
+//
+// With the PID tuner open in opcontrol, B with L1 held tunes all three, then
+// shows each loop's candidates on the tuner's screen to pick from, and the
+// tuner comes back with the picks. Needs room for a 24 in drive and a 90 deg
+// turn, the drive width and every loop's exit conditions set.
+
+enum class TuneLoop : uint8_t { TURN, DRIVE, SWING };
+
+struct TuneCandidate {
+    const char* name;
+    ez::PID::Constants constants;
+    uint32_t ms;  // for the move
+    double error; // where the move ended, in or deg
+    bool settled; // inside the small exit error
+};
+
+const int AUTOTUNE_CANDIDATES = 4; // the current gains, then one per TuneRule
+
+struct AutotuneResult {
+    RelayResult relay;
+    TuneCandidate candidates[AUTOTUNE_CANDIDATES];
+    int chosen; // the suggestion, index into candidates, 0 is the current gains
+};
+
+// Why the tuning can't run yet, nullptr if it can. The swing and turn moves
+// need the drive width, and a loop without a small exit error can't pass.
+const char* pid_autotune_unready();
+
+// Runs the experiment and the moves, then puts the current gains back. An
+// empty result with relay.ok false if pid_autotune_unready().
+AutotuneResult pid_autotune(TuneLoop loop);
+void pid_autotune_apply(TuneLoop loop, const ez::PID::Constants& constants);
+const char* tune_loop_name(TuneLoop loop);
+
+// The tuner's entry point: turn, drive then swing, each picked on the screen
+// (src/organiz/autotune_pick.cpp, brain only)
+void pid_autotune_all();
+
+#endif //ROBOT_AUTOTUNE
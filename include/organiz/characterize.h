@@ -0,0 +1,44 @@
+#ifndef ROBOT_CHARACTERIZE
+#define ROBOT_CHARACTERIZE
+#include "main.h"
+#include "feedforward_fit.h"
+#include "odometry.h"
+
+// Drive characterization. Runs a slow voltage ramp (quasistatic, for kS and
+// kV) and a voltage step (dynamic, for kA) forward and backward, logging
+// each side's voltage and tracking wheel every ODOM_PERIOD, and fits kS, kV
+// and kA per side (include/organiz/feedforward_fit.h).
+//
+// The fit feeds drive_profiled(), turn_profiled() and swing_profiled().
+// EZ's own drive, turn and swing loops have no feedforward term to feed.
+// With the PID tuner open in opcontrol, B runs it and saves the fit to
+// /usd/feedforward.txt, which initialize() loads. Needs about 4 ft clear in
+// front of and behind the robot.
+
+const double CHARACTERIZE_RAMP = 8;        // out of 127 per s, quasistatic
+const double CHARACTERIZE_STEP = 70;       // out of 127, dynamic
+const double CHARACTERIZE_DISTANCE = 48;   // in, a test stops once it has driven this far
+const uint32_t CHARACTERIZE_TIME = 6000;   // ms, or after this long
+const int CHARACTERIZE_SAMPLES_MAX = 4 * CHARACTERIZE_TIME / ODOM_PERIOD;
+
+struct DriveCharacterization {
+    FeedforwardFit left;
+    FeedforwardFit right;
+};
+
+// Runs the four tests, fits and applies the result. Writes the raw log to
+// log_path unless it's nullptr. Blocks for about 25 s.
+DriveCharacterization drive_characterize_run(const char* log_path = nullptr);
+
+// The tuner's entry point: logs to the next free /usd/char_NNN.bin, saves
+// the fit to /usd/feedforward.txt and prints it
+void drive_characterize();
+
+// Feeds the profiled drive, turn and swing
+void drive_feedforward_apply(Feedforward left, Feedforward right);
+
+bool drive_feedforward_save(const char* path, Feedforward left, Feedforward right);
+// Applies the fit in path, false if there isn't one
+bool drive_feedforward_load(const char* path);
+
+#endif //ROBOT_CHARACTERIZE
@@ -0,0 +1,57 @@
+#ifndef ROBOT_COLOR_SORT
+#define ROBOT_COLOR_SORT
+#include "main.h"
+#include "auton_registry.h"
+#include "ring_sort.h"
+
+// Color sort on the intake. color_checker's samples are classified by hue,
+// saturation and proximity (include/organiz/ring_sort.h), and each ring is
+// then followed up the intake by the intake's encoder, so the eject lands
+// at the same point on the hooks at any intake speed. The intake stops for
+// COLOR_SORT_EJECT_TIME as a wrong ring reaches the top and the hooks
+// throw it off.
+//
+// Everything that drives the intake goes through intake_set(), so an eject
+// can take over the motor and hand it back. See `./bin/sim --sort`.
+
+// ms, the sort loop runs once per sensor sample. The optical sensor's
+// default is 100 ms, long enough for a ring to pass unseen at full speed.
+const uint32_t COLOR_SORT_PERIOD = 10;
+const uint32_t COLOR_SORT_EJECT_TIME = 120; // ms the intake is stopped for
+
+// travel and latency are fitted to the sim's intake, placeholders until
+// they're measured on the robot: travel by turning the intake by hand from
+// a ring at the sensor to the eject point, latency from a telemetry log of
+// the intake's velocity after a brake.
+struct ColorSortTiming {
+    double travel = 700;  // deg of intake from the sensor to the eject point, placeholder
+    double latency = 40;  // ms from stopping the intake to the hooks slowing, placeholder
+    double sample_age = COLOR_SORT_PERIOD / 2.0; // ms, middle of the integration window
+};
+
+// Sets the sensor's integration time and LED and starts the loop
+void color_sort_start();
+
+// The color to throw out, NONE turns sorting off
+void color_sort_set(RingColor reject);
+RingColor color_sort_get();
+// Throws out the other alliance's rings, NONE turns sorting off. opcontrol()
+// sets it from the auton pick, so a color an auton set doesn't carry over.
+void color_sort_alliance_set(Alliance ours);
+
+void color_sort_timing_set(ColorSortTiming timing);
+
+// Drives the intake, -127 to 127, 0 brakes it
+void intake_set(int power);
+
+struct ColorSortStats {
+    int red;
+    int blue;
+    int ejected;
+};
+ColorSortStats color_sort_stats();
+void color_sort_stats_reset();
+
+extern PeriodicLoop color_sort_loop;
+
+#endif //ROBOT_COLOR_SORT
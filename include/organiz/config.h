@@ -0,0 +1,84 @@
+#ifndef ROBOT_CONFIG_STORE
+#define ROBOT_CONFIG_STORE
+#include <cstdint>
+#include <type_traits>
+
+#include "main.h"
+#include "odom_math.h"
+#include "profiled_drive.h"
+#include "mechanism.h"
+#include "settle.h"
+
+// Tuned constants on the SD card, so a change in the PID tuner doesn't need
+// a rebuild. default_constants() (src/autons.cpp) still sets everything, then
+// initialize() loads /usd/config.bin over it if there's a good one. The file
+// is a header and one raw RobotConfig, read with a single fread. Closing the
+// tuner offers to write it back, and B saves.
+//
+// A file from an older layout, a different robot or a half-finished write
+// fails the magic, version, size or checksum and is ignored, so the compiled
+// in constants are what runs. The header also keeps a hash of the constants
+// default_constants() set when it was saved, so after default_constants()
+// changes the file is ignored too and the edit isn't silently overridden.
+
+struct PidGains {
+    double kp, ki, kd, start_i;
+};
+
+struct SlewConstants {
+    double distance; // in for drives, deg for turns and swings
+    double min_speed;
+};
+
+struct RobotConfig {
+    // ez::Drive, drives in in and turns and swings in deg
+    PidGains heading, drive_forward, drive_backward, turn, swing_forward, swing_backward;
+    ExitLimits drive_exit, turn_exit, swing_exit;
+    SlewConstants slew_drive_forward, slew_drive_backward, slew_turn, slew_swing_forward, slew_swing_backward;
+    double chain_drive_forward, chain_drive_backward, chain_turn, chain_swing_forward, chain_swing_backward;
+
+    DriveProfileConstants profile;
+    SettleMode settle_mode;
+    double settle_horizon;
+
+    OdomIntegrator odom_integrator;
+    OdomHeading odom_heading;
+    bool odom_ekf;
+
+    // lady_brown
+    ProfileLimits arm_limits;
+    ArmGains arm_gains;
+    PidGains arm_pid;
+    ExitLimits arm_exit;
+};
+
+const char* const CONFIG_PATH = "/usd/config.bin";
+const uint32_t CONFIG_MAGIC = 0x4B553138; // "81UK"
+const uint16_t CONFIG_VERSION = 3;
+
+struct ConfigHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;     // sizeof(RobotConfig)
+    uint32_t checksum; // FNV-1a of the config
+    uint32_t defaults; // FNV-1a of default_constants()'s config
+};
+
+// Like the trajectory packs, the brain and x86-64 hosts agree on this layout
+static_assert(std::is_trivially_copyable<RobotConfig>::value, "the config is stored raw");
+static_assert(sizeof(RobotConfig) == 680, "RobotConfig layout changed, bump CONFIG_VERSION");
+
+// The constants running now
+RobotConfig config_capture();
+void config_apply(const RobotConfig& config);
+
+// Takes what's running now as default_constants()'s, call it right after
+void config_defaults_mark();
+
+// Applies the file. False if it's missing, bad or saved over other defaults,
+// nothing changes then.
+bool config_load(const char* path);
+// Writes what's running now. False if the file can't be written.
+bool config_save(const char* path);
+
+#endif //ROBOT_CONFIG_STORE
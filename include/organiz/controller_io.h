@@ -0,0 +1,57 @@
+#ifndef ROBOT_CONTROLLER_IO
+#define ROBOT_CONTROLLER_IO
+#include <cstdint>
+
+#include "main.h"
+
+// Controller and screen I/O for opcontrol. controller_poll() reads every
+// button, both sticks and the brain's LCD buttons once a tick, and presses
+// and releases are worked out from the last poll, so the loop asks a struct
+// instead of the radio.
+//
+// Screen writes are queued. The ui loop only sends the latest text for each
+// line, and only when it changed: the controller takes one write (a line or
+// a rumble) every CONTROLLER_WRITE_PERIOD over VEXnet and drops the rest,
+// and LCD lines are redrawn at most every UI_PERIOD. Nothing here blocks
+// the drive. EZ's auton selector and PID tuner still write their own.
+
+const uint32_t UI_PERIOD = 50;                // ms
+const uint32_t CONTROLLER_WRITE_PERIOD = 50;  // ms, one controller write each
+const int LCD_LINES = 8;
+const int CONTROLLER_LINES = 3;
+const int CONTROLLER_COLUMNS = 15;
+
+constexpr uint32_t button_bit(pros::controller_digital_e_t button) {
+    return 1u << (button - pros::E_CONTROLLER_DIGITAL_L1);
+}
+
+struct ControllerState {
+    uint32_t held = 0;       // button_bit()s
+    uint32_t pressed = 0;    // went down since the last poll
+    uint32_t released = 0;   // came up since the last poll
+    int axes[4] = {};        // -127 to 127, by pros::controller_analog_e_t
+    uint8_t lcd_buttons = 0; // LCD_BTN_LEFT, CENTER and RIGHT held
+
+    bool down(pros::controller_digital_e_t button) const { return held & button_bit(button); }
+    bool new_press(pros::controller_digital_e_t button) const { return pressed & button_bit(button); }
+    bool new_release(pros::controller_digital_e_t button) const { return released & button_bit(button); }
+    int axis(pros::controller_analog_e_t stick) const { return axes[stick]; }
+};
+
+// Reads master once, at the top of each opcontrol tick
+const ControllerState& controller_poll();
+const ControllerState& controller_get();
+
+// printf style, the line is redrawn with the latest text
+void lcd_text_set(int line, const char* fmt, ...);
+void controller_text_set(int line, const char* fmt, ...);
+// Sends every LCD line again, after something else drew on the screen
+void lcd_redraw();
+// A pattern like master.rumble()'s, sent ahead of any text
+void controller_rumble(const char* pattern);
+
+void ui_start();
+
+extern PeriodicLoop ui_loop;
+
+#endif //ROBOT_CONTROLLER_IO
@@ -0,0 +1,45 @@
+#ifndef ROBOT_DRIVE_IO
+#define ROBOT_DRIVE_IO
+#include "main.h"
+
+// Drive I/O for our own control loops. read() takes everything a tick needs
+// at one point in the tick, and set() writes both sides. It's the same device
+// calls as asking chassis directly, through chassis' own motors, so nothing
+// here is faster, just one consistent snapshot per tick. EZ's own tasks write
+// the same motors, so only set() through here with the chassis in DISABLE.
+
+// Drive motor ports, back to front, negative reverses. chassis is built from
+// these.
+inline const std::vector<int> DRIVE_LEFT_PORTS = {-11, -16, -13};
+inline const std::vector<int> DRIVE_RIGHT_PORTS = {12, 17, 14};
+
+// Encoders and IMU, a few device calls
+struct DriveSnapshot {
+    uint32_t time;      // ms
+    double left, right; // in, same as chassis.drive_sensor_left/right()
+    double imu;         // deg, same as chassis.drive_imu_get()
+    double gyro_rate;   // deg/s, clockwise positive like imu
+};
+
+// Three calls per motor, so only for loops that log or fit against it
+struct DriveHealth {
+    double left_velocity; // rpm, average of the side
+    double right_velocity;
+    double left_current;  // mA, average of the side
+    double right_current;
+    double left_voltage;  // mV, average of the side
+    double right_voltage;
+};
+
+class DriveIO {
+   public:
+    void read(DriveSnapshot& out);
+    void health_read(DriveHealth& out);
+
+    // -127 to 127 like chassis.drive_set()
+    void set(double left, double right);
+};
+
+extern DriveIO drive_io;
+
+#endif //ROBOT_DRIVE_IO
@@ -0,0 +1,77 @@
+#ifndef ROBOT_FEEDFORWARD_FIT
+#define ROBOT_FEEDFORWARD_FIT
+#include <cstddef>
+#include <cstdint>
+
+#include "matrix.h"
+
+// Drive feedforward from a characterization run (include/organiz/characterize.h).
+// Output (out of 127) = kS * sgn(v) + kV * v + kA * a, fit by least squares
+// to the voltage, velocity and acceleration of each side. Pure math and the
+// log format, so a recording fits the same on a computer:
+//
+//   make ff_fit && ./bin/ff_fit char_000.bin
+
+struct Feedforward {
+    double kS;
+    double kV; // per in/s
+    double kA; // per in/s^2
+};
+
+inline double feedforward(const Feedforward& ff, double velocity, double accel) {
+    double sgn = velocity > 0 ? 1 : velocity < 0 ? -1 : 0;
+    return ff.kS * sgn + ff.kV * velocity + ff.kA * accel;
+}
+
+const uint32_t CHARACTERIZE_MAGIC = 0x43553138; // "81UC"
+const uint16_t CHARACTERIZE_VERSION = 1;
+
+// A log is one CharacterizeHeader followed by back-to-back CharacterizeSamples
+struct CharacterizeHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t sample_size;
+};
+
+struct CharacterizeSample {
+    uint32_t time_ms;
+    float out_left;  // voltage the motors saw, out of 127
+    float out_right;
+    float left;      // in, tracking wheels
+    float right;
+};
+
+static_assert(sizeof(CharacterizeHeader) == 8, "CharacterizeHeader layout changed");
+static_assert(sizeof(CharacterizeSample) == 20, "CharacterizeSample layout changed, bump CHARACTERIZE_VERSION");
+
+struct FeedforwardFit {
+    Feedforward ff;
+    double r2;   // of the fit, 1 is perfect
+    int samples; // used, 0 if nothing could be fit
+};
+
+// Running sums for the least squares fit, so fitting stores no samples
+class FeedforwardFitter {
+   public:
+    void add(double out, double velocity, double accel);
+    FeedforwardFit fit() const;
+
+   private:
+    Matrix<3, 3> xtx;
+    Matrix<3, 1> xty;
+    double yy = 0;
+    double y = 0;
+    int n = 0;
+};
+
+// A longer jump between samples is a break between tests
+const uint32_t FEEDFORWARD_GAP = 50; // ms
+
+// Velocity and acceleration by central differences window samples either
+// side, then a fit per side. Windows across a break are skipped. Samples
+// slower than v_min (in/s) are left out, static friction makes them say
+// nothing about kS.
+void feedforward_fit_log(const CharacterizeSample* log, size_t count, FeedforwardFit& left, FeedforwardFit& right,
+                         int window = 4, double v_min = 1.0);
+
+#endif //ROBOT_FEEDFORWARD_FIT
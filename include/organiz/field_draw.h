@@ -0,0 +1,95 @@
+#ifndef ROBOT_FIELD_DRAW
+#define ROBOT_FIELD_DRAW
+#include <cstddef>
+#include <cstdint>
+
+#include "path_follower.h"
+
+// What the brain screen field view (include/organiz/field_view.h) draws and
+// how much of the screen each change invalidates. Pure math so the sim
+// (`./bin/sim --field`) counts the same pixels the brain redraws.
+//
+// Screen pixels are x right and y down. The field is FIELD_VIEW_PX square
+// at the left of the 480 x 240 screen, odom is inches with y up the field.
+
+const int FIELD_VIEW_PX = 240;
+const double FIELD_IN = 144;           // 12 ft
+const uint32_t FIELD_VIEW_PERIOD = 40; // ms, LV_DISP_DEF_REFR_PERIOD
+const int FIELD_LINE_WIDTH = 2;        // px, the robot and path lines
+const double FIELD_ROBOT_LENGTH = 18;  // in
+const double FIELD_ROBOT_WIDTH = 18;   // in
+
+// Same layout as lv_point_t
+struct PixelPoint {
+    int16_t x, y;
+
+    bool operator==(const PixelPoint&) const = default;
+};
+
+// Corners inclusive, like lv_area_t
+struct PixelRect {
+    int16_t x1, y1, x2, y2;
+
+    bool empty() const { return x2 < x1 || y2 < y1; }
+    int32_t area() const { return empty() ? 0 : (int32_t)(x2 - x1 + 1) * (y2 - y1 + 1); }
+};
+
+PixelRect rect_join(const PixelRect& a, const PixelRect& b);
+bool rect_overlap(const PixelRect& a, const PixelRect& b);
+// Box around the points, grown by pad on every side for line width
+PixelRect rect_bounds(const PixelPoint* points, int count, int pad = 0);
+
+// Pixels LVGL redraws when an object moves from old_area to new_area: one
+// area if they overlap, both otherwise
+int32_t moved_area(const PixelRect& old_area, const PixelRect& new_area);
+
+// Odom to screen. The origin is where odom (0, 0) sits, in from the field's
+// bottom left corner.
+struct FieldProjection {
+    double origin_x = FIELD_IN / 2;
+    double origin_y = FIELD_IN / 2;
+
+    PixelPoint to_px(double x, double y) const;
+};
+
+// The robot as a closed outline with a point at the front, so the heading
+// shows: front left, nose, front right, back right, back left, front left
+const int ROBOT_MARKER_POINTS = 6;
+
+struct RobotMarker {
+    PixelPoint points[ROBOT_MARKER_POINTS];
+
+    bool operator==(const RobotMarker&) const = default;
+};
+
+// theta in deg like ez::pose, length and width in in
+RobotMarker robot_marker(const FieldProjection& proj, double x, double y, double theta, double length, double width);
+
+// The path as at most max screen points, evenly picked and keeping both
+// ends. Returns how many were written.
+int path_pixels(const FieldProjection& proj, const PathPoint* path, size_t count, PixelPoint* out, int max);
+
+// Keeps a frame's cost, the view's update plus LVGL's render of what it
+// invalidated, under a budget by drawing every skip'th period. Over budget
+// doubles skip, under half of it halves skip again.
+class FramePacer {
+   public:
+    explicit FramePacer(uint32_t budget_us = 4000, int max_skip = 8);
+
+    void budget_set(uint32_t us) { budget_us = us; }
+    uint32_t budget_get() const { return budget_us; }
+
+    // Once a period, true when this one should draw
+    bool frame();
+    // What the last drawn frame cost
+    void drawn(uint32_t cost_us);
+    int skip_get() const { return skip; }
+
+   private:
+    uint32_t budget_us;
+    int max_skip;
+    int skip = 1;
+    int countdown = 0;
+};
+
+#endif //ROBOT_FIELD_DRAW
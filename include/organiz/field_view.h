@@ -0,0 +1,46 @@
+#ifndef ROBOT_FIELD_VIEW
+#define ROBOT_FIELD_VIEW
+#include <cstddef>
+#include <cstdint>
+
+#include "main.h"
+#include "field_draw.h"
+
+// Live field on the brain screen for practice: the odom pose, the planned
+// path and where the running PID motion is headed, with the pose and the
+// frame cost beside it.
+//
+// The tiles are drawn once into a canvas, which LVGL keeps as an image, and
+// the robot, path and target are small objects on top of it. LVGL only
+// redraws the areas an object left or moved into, from the cached image, so
+// a frame costs a few robot sized boxes instead of the whole field, and a
+// robot that sits still costs nothing. The view runs below every control
+// loop, and a FramePacer (include/organiz/field_draw.h) drops frames when
+// one costs more than the budget.
+
+const int FIELD_PATH_POINTS = 48; // the path line's points at most
+
+// Shows the view in place of the LLEMU screen, or puts LLEMU back. The
+// objects are made on the first show.
+void field_view_show(bool show);
+bool field_view_shown();
+
+// Where odom (0, 0) is, in from the field's bottom left corner. The center by default.
+void field_view_origin_set(double x, double y);
+// Drawn until the next call, nullptr or 0 points clears it
+void field_view_path_set(const PathPoint* points, size_t count);
+
+// Per frame, the view's update plus LVGL's render. 5 ms by default.
+void field_view_budget_set(uint32_t us);
+
+struct FieldViewStats {
+    uint32_t frames;
+    uint32_t dropped;     // periods the pacer skipped
+    uint32_t last_us;     // cost of the last drawn frame
+    uint32_t max_us;
+    uint32_t last_px;     // pixels LVGL last redrew
+};
+
+FieldViewStats field_view_stats();
+
+#endif //ROBOT_FIELD_VIEW
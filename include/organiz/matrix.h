@@ -0,0 +1,90 @@
+#ifndef ROBOT_MATRIX
+#define ROBOT_MATRIX
+#include <cmath>
+#include <utility>
+
+// Fixed-size matrices for small filters. Sizes are template parameters, so
+// everything lives on the stack and the loops unroll, nothing allocates.
+
+template <int R, int C>
+struct Matrix {
+    double m[R][C] = {};
+
+    double& operator()(int r, int c) { return m[r][c]; }
+    double operator()(int r, int c) const { return m[r][c]; }
+
+    static Matrix identity() {
+        static_assert(R == C, "identity of a non-square matrix");
+        Matrix out;
+        for (int i = 0; i < R; i++) out.m[i][i] = 1;
+        return out;
+    }
+
+    Matrix<C, R> transpose() const {
+        Matrix<C, R> out;
+        for (int r = 0; r < R; r++)
+            for (int c = 0; c < C; c++) out.m[c][r] = m[r][c];
+        return out;
+    }
+
+    Matrix operator+(const Matrix& o) const {
+        Matrix out;
+        for (int r = 0; r < R; r++)
+            for (int c = 0; c < C; c++) out.m[r][c] = m[r][c] + o.m[r][c];
+        return out;
+    }
+
+    Matrix operator-(const Matrix& o) const {
+        Matrix out;
+        for (int r = 0; r < R; r++)
+            for (int c = 0; c < C; c++) out.m[r][c] = m[r][c] - o.m[r][c];
+        return out;
+    }
+
+    template <int K>
+    Matrix<R, K> operator*(const Matrix<C, K>& o) const {
+        Matrix<R, K> out;
+        for (int r = 0; r < R; r++)
+            for (int k = 0; k < K; k++) {
+                double sum = 0;
+                for (int c = 0; c < C; c++) sum += m[r][c] * o.m[c][k];
+                out.m[r][k] = sum;
+            }
+        return out;
+    }
+};
+
+// Gauss-Jordan with partial pivoting. Returns false if a is singular.
+template <int N>
+bool matrix_invert(const Matrix<N, N>& a, Matrix<N, N>& out) {
+    Matrix<N, N> work = a;
+    out = Matrix<N, N>::identity();
+    for (int col = 0; col < N; col++) {
+        int pivot = col;
+        for (int r = col + 1; r < N; r++) {
+            if (std::fabs(work.m[r][col]) > std::fabs(work.m[pivot][col])) pivot = r;
+        }
+        if (std::fabs(work.m[pivot][col]) < 1e-12) return false;
+        for (int c = 0; c < N; c++) {
+            std::swap(work.m[col][c], work.m[pivot][c]);
+            std::swap(out.m[col][c], out.m[pivot][c]);
+        }
+
+        double scale = 1 / work.m[col][col];
+        for (int c = 0; c < N; c++) {
+            work.m[col][c] *= scale;
+            out.m[col][c] *= scale;
+        }
+        for (int r = 0; r < N; r++) {
+            if (r == col) continue;
+            double f = work.m[r][col];
+            for (int c = 0; c < N; c++) {
+                work.m[r][c] -= f * work.m[col][c];
+                out.m[r][c] -= f * out.m[col][c];
+            }
+        }
+    }
+    return true;
+}
+
+#endif //ROBOT_MATRIX
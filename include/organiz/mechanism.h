@@ -0,0 +1,84 @@
+#ifndef ROBOT_MECHANISM
+#define ROBOT_MECHANISM
+#include "main.h"
+#include "motion_profile.h"
+#include "seqlock.h"
+
+// Position control for arm joints (the lady brown). Moves between named
+// states on a trapezoidal profile, with gravity feedforward that follows the
+// arm's angle and an ez::PID tracking the profile. Once the profile ends
+// the PID's exit conditions decide when the arm has settled, so autons can
+// wait on it like they wait on the drive.
+//
+// Positions are degrees of the rotation sensor.
+
+struct ArmState {
+    const char* name;
+    double position; // deg
+};
+
+// Output (out of 127) = kG * cos(position - level) + kS * sgn(v) + kV * v + kA * a + pid
+struct ArmGains {
+    double kG;    // holds the arm level
+    double level; // deg, sensor reading with the arm level
+    double kS;
+    double kV;    // per deg/s
+    double kA;    // per deg/s^2
+};
+
+struct ArmConstants {
+    ProfileLimits limits;
+    ArmGains gains;
+};
+
+class ArmController {
+   public:
+    ArmController(pros::Motor& motor, pros::Rotation& sensor, const ArmState* states, int count);
+
+    // Tracks the profile, set constants and exit conditions like chassis PIDs
+    ez::PID pid;
+
+    // update() sees all of the old constants or all of the new ones, never
+    // some of each. Set them from one task at a time.
+    void constants_set(ProfileLimits limits, ArmGains gains);
+    ProfileLimits limits_get() const { return constants.read().limits; }
+    ArmGains gains_get() const { return constants.read().gains; }
+
+    // Starts a profile from wherever the arm is now
+    void state_set(int index);
+    void state_set(const char* name);
+    // Next state, wrapping back to the first
+    void state_next();
+    int state_get() const { return state.load(); }
+    // Position of the current state, deg
+    double target_get() const { return states[state.load()].position; }
+
+    double position_get() const;
+
+    // Runs one tick, call every ez::util::DELAY_TIME. Leaves the motor alone
+    // while the robot is disabled and re-plans from wherever the arm is once
+    // it's enabled again.
+    void update();
+
+    bool settled() const { return is_settled; }
+    // Blocks until the arm settles or timeout_ms passes
+    void wait_until_settled(int timeout_ms = 2000);
+
+   private:
+    pros::Motor& motor;
+    pros::Rotation& sensor;
+    const ArmState* states;
+    int count;
+
+    Seqlock<ArmConstants> constants;
+
+    MotionProfile profile;
+    double start_position = 0;
+    uint32_t start_time = 0;
+    // Set from the controller or auton task, read on update()'s
+    std::atomic<int> state{0};
+    std::atomic<bool> replan{true};
+    std::atomic<bool> is_settled{false};
+};
+
+#endif //ROBOT_MECHANISM
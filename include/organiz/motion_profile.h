@@ -0,0 +1,86 @@
+#ifndef ROBOT_MOTION_PROFILE
+#define ROBOT_MOTION_PROFILE
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+// Time-optimal 1D profiles for straight drives. With jerk set this is a
+// 7 segment S-curve, with jerk 0 it is a plain trapezoid. Pure math so the
+// host tools can plan the same profiles the brain does.
+
+struct ProfileLimits {
+    double velocity; // in/s
+    double accel;    // in/s^2
+    double jerk;     // in/s^3, 0 for a trapezoid
+
+    bool operator==(const ProfileLimits&) const = default;
+};
+
+struct ProfilePoint {
+    double position; // in
+    double velocity; // in/s
+    double accel;    // in/s^2
+};
+
+class MotionProfile {
+   public:
+    MotionProfile() = default;
+    MotionProfile(double distance, ProfileLimits limits);
+
+    // Setpoint t seconds after the start, holds the end point after duration()
+    ProfilePoint at(double t) const;
+    double duration() const { return total_time; }
+    double distance() const { return target; }
+    ProfileLimits limits_get() const { return limits; }
+
+   private:
+    struct Segment {
+        double start;    // s
+        double length;   // s
+        double jerk;
+        ProfilePoint begin;
+    };
+
+    std::array<Segment, 7> segments{};
+    ProfileLimits limits{};
+    double target = 0;
+    double total_time = 0;
+};
+
+// Planned profiles are kept, so asking for the same distance and limits
+// again costs a lookup. Not thread safe, plan from one task.
+// Profiles loaded from a pack are checked first and never planned.
+const MotionProfile& profile_get(double distance, ProfileLimits limits);
+
+///
+// Trajectory packs: profiles planned on a computer and stored as raw
+// MotionProfile records, so loading is one fread with nothing to parse.
+// `./bin/sim --pack profiles.bin` writes one with every profile the autons
+// ask for, copy it to the SD card as /usd/profiles.bin.
+///
+const uint32_t PROFILE_PACK_MAGIC = 0x50553138; // "81UP"
+const uint16_t PROFILE_PACK_VERSION = 1;
+const int PROFILE_PACK_MAX = 32;
+
+struct ProfilePackHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t count;
+    uint32_t checksum; // FNV-1a of the records
+};
+
+// The brain and x86-64 hosts agree on this layout (little-endian, 8 byte aligned doubles)
+static_assert(std::is_trivially_copyable<MotionProfile>::value, "pack records are raw MotionProfiles");
+static_assert(sizeof(MotionProfile) == 376, "MotionProfile layout changed, bump PROFILE_PACK_VERSION");
+
+// The checksum packs and the config store (include/organiz/config.h) use
+uint32_t fnv1a(const void* data, size_t size);
+
+// Replaces the loaded pack. Returns the number of profiles, or -1 if the file is missing or bad.
+int profile_pack_load(const char* path);
+
+// Writes every profile planned or loaded so far. Returns false if the file can't be written.
+bool profile_pack_write(const char* path);
+
+#endif //ROBOT_MOTION_PROFILE
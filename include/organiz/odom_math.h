@@ -0,0 +1,59 @@
+#ifndef ROBOT_ODOM_MATH
+#define ROBOT_ODOM_MATH
+#include <cmath>
+#include <cstdint>
+
+// One odometry step, shared by the 5 ms odom task, testfile.cpp's Odometry
+// and the simulator's drift benchmark (`./bin/sim --drift`).
+
+enum class OdomIntegrator : uint8_t {
+    EULER,    // move along the heading at the start of the step
+    MIDPOINT, // move along the average heading of the step
+    ARC,      // constant curvature, exact for a drive turning at a steady rate
+};
+
+// Where the heading change of a step comes from
+enum class OdomHeading : uint8_t {
+    IMU,    // the IMU's own heading
+    WHEELS, // difference of the tracking wheels over the track width, scrub shows up as heading error
+    FUSED,  // HeadingFilter over the gyro rate, the wheels and the IMU heading
+};
+
+// Straight-line move of a step: how far, and which way relative to the
+// heading at the start of the step (radians, same sign as d_theta)
+struct OdomStep {
+    double length;
+    double angle;
+};
+
+// d is the distance the center traveled, d_theta the turn in radians
+inline OdomStep odom_step(OdomIntegrator integrator, double d, double d_theta) {
+    switch (integrator) {
+        case OdomIntegrator::EULER:
+            return {d, 0};
+        case OdomIntegrator::MIDPOINT:
+            return {d, d_theta / 2};
+        default:
+            // The chord of the arc, 2 r sin(d_theta / 2) with r = d / d_theta
+            if (std::fabs(d_theta) < 1e-9) return {d, d_theta / 2};
+            return {2 * d / d_theta * std::sin(d_theta / 2), d_theta / 2};
+    }
+}
+
+// Complementary heading filter. The gyro rate and tracking wheel deltas
+// carry the heading from one step to the next, and a small pull toward the
+// IMU's own heading each step removes their drift. Any angle unit works as
+// long as all three inputs use it.
+struct HeadingFilter {
+    double gyro_weight = 0.8; // gyro vs wheels for the step
+    double imu_weight = 0.1;  // fraction of the gap to the IMU heading closed per step
+    double theta = 0;
+
+    double update(double gyro_delta, double wheel_delta, double imu_heading) {
+        theta += gyro_weight * gyro_delta + (1 - gyro_weight) * wheel_delta;
+        theta += imu_weight * (imu_heading - theta);
+        return theta;
+    }
+};
+
+#endif //ROBOT_ODOM_MATH
@@ -0,0 +1,69 @@
+#ifndef ROBOT_ODOMETRY
+#define ROBOT_ODOMETRY
+#include "main.h"
+#include "odom_math.h"
+#include "pose_ekf.h"
+#include "seqlock.h"
+
+// Odometry on its own 5 ms task, the rate the rotation sensors and IMU are
+// set to, instead of sharing EZ's 10 ms task with the PIDs. Each update is
+// published through a Seqlock, so readers never wait on the odom task and
+// the odom task never waits on them.
+//
+// Same conventions as ez::pose: inches, degrees, 0 facing +y, clockwise positive.
+
+struct OdomState {
+    uint64_t time_us; // pros::micros() of the sensor reads
+    double x, y, theta;
+    double vx, vy;    // in/s
+    double omega;     // deg/s
+};
+
+const uint32_t ODOM_PERIOD = 5;      // ms
+const uint32_t ODOM_GPS_PERIOD = 20; // ms, how often a GPS fix is used
+
+// Sets the sensor data rates and starts the task.
+void odom_start();
+
+// How each step is integrated, ARC by default. See `./bin/sim --drift`.
+void odom_integrator_set(OdomIntegrator integrator);
+OdomIntegrator odom_integrator_get();
+
+// Where the heading comes from, IMU by default. With WHEELS or FUSED the
+// heading is only taken from the IMU on odom_reset, so call it after
+// drive_angle_set. Both need chassis.drive_width_set() first, false and
+// left on the IMU without it.
+bool odom_heading_set(OdomHeading heading);
+OdomHeading odom_heading_get();
+
+// Runs the EKF (include/organiz/pose_ekf.h) on the odom task, off by
+// default. While on, the published pose is the filter's, and every GPS or
+// corrector correction is also added to chassis.odom_pose_get() so EZ's
+// odom motions drive on the corrected pose, on the first odom step that
+// finds EZ's task between updates.
+void odom_ekf_enable(bool enable);
+bool odom_ekf_enabled();
+
+// GPS for the EKF to correct with, nullptr for none. (origin_x, origin_y) is
+// where the odom origin is in the GPS's field coordinates, in. The robot
+// must face the GPS's 0 heading at odom 0.
+void odom_gps_set(pros::Gps* gps, double origin_x, double origin_y);
+
+// Runs on the odom task after each EKF step, for corrections from other
+// sensors, e.g. ekf.update_range() with distance sensors against the walls.
+using OdomCorrector = void (*)(PoseEkf& ekf, const DriveSnapshot& snap);
+void odom_corrector_set(OdomCorrector corrector);
+
+// Moves the position to (x, y), takes effect on the next update. Heading
+// restarts from chassis.drive_imu_get(), set it with drive_angle_set().
+void odom_reset(double x, double y);
+
+// Newest published update.
+OdomState odom_state();
+
+// Newest update carried forward at its velocity to time_us, so a consumer
+// running on its own clock sees where the robot is now, not up to 5 ms ago.
+ez::pose odom_pose_at(uint64_t time_us);
+ez::pose odom_pose_now();
+
+#endif //ROBOT_ODOMETRY
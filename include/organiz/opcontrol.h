@@ -1,8 +1,14 @@
 #ifndef ROBOT_OPCONTROL
+#define ROBOT_OPCONTROL
 #include "main.h"
 
-void intake_func();
+// Lady brown on ArmController (include/organiz/mechanism.h), gains in
+// default_constants()
 void lb_nextState();
 void lb_liftControl();
 
+extern ArmController lady_brown;
+
+extern PeriodicLoop lb_loop;
+
 #endif //ROBOT_OPCONTROL
\ No newline at end of file
@@ -1,3 +1,21 @@
 #include "robot_config.h"
+#include "scheduler.h"
+#include "telemetry.h"
+#include "drive_io.h"
+#include "odometry.h"
+#include "relocalize.h"
+#include "profiled_drive.h"
+#include "characterize.h"
+#include "autotune.h"
+#include "settle.h"
+#include "routine.h"
+#include "timeline.h"
+#include "mechanism.h"
+#include "color_sort.h"
 #include "opcontrol.h"
+#include "controller_io.h"
+#include "auton_select.h"
+#include "field_view.h"
+#include "config.h"
+#include "path_drive.h"
 #include "main.h"
\ No newline at end of file
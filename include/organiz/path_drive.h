@@ -0,0 +1,55 @@
+#ifndef ROBOT_PATH_DRIVE
+#define ROBOT_PATH_DRIVE
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+#include "main.h"
+#include "path_plan.h"
+
+// EZ's pure pursuit on paths from a PathCache (include/organiz/path_plan.h),
+// in place of pid_odom_smooth_pp_set(), which smooths before the robot
+// moves. By default pid_path_set() drives the smoothed path, so an auton
+// runs the same on its first run after boot as on later ones. A path it
+// hasn't seen is smoothed on the spot, no slower than EZ's smoothing before
+// the move (path_bench times both). raw_first instead starts on the straight
+// injected path at once and leaves the smoothing to a loop below the control
+// loops, for the next time the path is driven. path_prepare() queues that
+// smoothing early, to have it done before the routine gets there. A path
+// driven again, like the repeated ones in skills, comes straight from the
+// cache.
+//
+// Unlike EZ's, the path starts at the first waypoint instead of wherever the
+// robot is, so the same waypoints always plan the same path. Each point
+// takes the direction, speed and turn behavior of the waypoint it's headed
+// for, and only the last one keeps its angle.
+
+const uint32_t PATH_SMOOTH_PERIOD = 10; // ms
+const int PATH_SWEEPS_PER_PERIOD = 25;
+
+void path_smoothing_set(const PathSmoothing& smoothing);
+const PathSmoothing& path_smoothing_get();
+
+// Plans the path and queues its smoothing, for a pid_path_set() later on
+void path_prepare(const ez::odom* waypoints, size_t count);
+void path_prepare(std::initializer_list<ez::odom> waypoints);
+
+// Waits on the loop for a path_prepare() it hasn't finished, unless
+// raw_first. Falls back to pid_odom_injected_pp_set() if the path doesn't
+// fit. Fewer than 2 waypoints is nothing to drive.
+void pid_path_set(const ez::odom* waypoints, size_t count, bool slew = false, bool raw_first = false);
+void pid_path_set(std::initializer_list<ez::odom> waypoints, bool slew = false, bool raw_first = false);
+
+struct PathStats {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t smoothed_now; // new paths pid_path_set() smoothed itself
+    uint32_t waits;        // pid_path_set() calls that waited on the loop
+    uint32_t raw_starts;   // raw_first calls that started on the straight path
+    uint32_t fallbacks;    // paths handed to EZ to inject
+    int last_sweeps;       // of the last path driven
+};
+
+PathStats path_stats();
+
+#endif //ROBOT_PATH_DRIVE
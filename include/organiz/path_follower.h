@@ -0,0 +1,116 @@
+#ifndef ROBOT_PATH_FOLLOWER
+#define ROBOT_PATH_FOLLOWER
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// Pure pursuit lookups that cost the same every tick whatever the path
+// length. Pure math so the host benchmark runs the same code.
+//
+// Benchmark: `make path_bench && ./bin/path_bench`
+
+// Same spacing EZ uses when it injects points
+const double PATH_SPACING = 0.5; // in
+
+struct PathPoint {
+    double x;
+    double y;
+};
+
+// Points every `spacing` inches along the straight lines between waypoints,
+// the same as EZ's inject_points
+std::vector<PathPoint> inject_points(const std::vector<PathPoint>& waypoints, double spacing = PATH_SPACING);
+
+// Works on anything with .x and .y. Both the closest point and the lookahead
+// only move forward along the path, and each only looks at a bounded window
+// ahead of where it was last tick.
+template <typename P>
+class PathCursor {
+   public:
+    // Points searched ahead of the closest point, 16 in at PATH_SPACING
+    static const size_t WINDOW = 32;
+    // Segments searched for the lookahead, enough for a 48 in radius at PATH_SPACING
+    static const size_t LOOKAHEAD_WINDOW = 96;
+
+    void reset(const P* p_points, size_t p_count) {
+        points = p_points;
+        count = p_count;
+        cursor = 0;
+        lookahead_segment = 0;
+    }
+
+    // Index of the closest point at or ahead of last tick's
+    size_t closest(double x, double y) {
+        if (count == 0) return 0;
+        size_t end = std::min(count, cursor + WINDOW + 1);
+        double best = distance_sq(cursor, x, y);
+        for (size_t i = cursor + 1; i < end; i++) {
+            double d = distance_sq(i, x, y);
+            if (d < best) {
+                best = d;
+                cursor = i;
+            }
+        }
+        return cursor;
+    }
+
+    // Where a circle of `radius` around (x, y) leaves the path. Returns the
+    // last point once the end of the path is inside the circle, and the
+    // closest point from closest() if the circle doesn't reach the path.
+    // With no path it returns false and leaves (x, y) in the outputs.
+    bool lookahead(double x, double y, double radius, double& out_x, double& out_y) {
+        if (count == 0) {
+            out_x = x;
+            out_y = y;
+            return false;
+        }
+        if (lookahead_segment < cursor) lookahead_segment = cursor;
+
+        size_t end = std::min(count - 1, lookahead_segment + LOOKAHEAD_WINDOW);
+        double r_sq = radius * radius;
+        for (size_t i = lookahead_segment; i < end; i++) {
+            // Solve |p1 + t (p2 - p1) - c|^2 = r^2 for the exit root
+            double dx = points[i + 1].x - points[i].x;
+            double dy = points[i + 1].y - points[i].y;
+            double fx = points[i].x - x;
+            double fy = points[i].y - y;
+            double a = dx * dx + dy * dy;
+            double b = 2 * (fx * dx + fy * dy);
+            double c = fx * fx + fy * fy - r_sq;
+            double disc = b * b - 4 * a * c;
+            if (a == 0 || disc < 0) continue;
+
+            double t = (-b + std::sqrt(disc)) / (2 * a);
+            if (t >= 0 && t <= 1) {
+                lookahead_segment = i;
+                out_x = points[i].x + t * dx;
+                out_y = points[i].y + t * dy;
+                return true;
+            }
+        }
+
+        // No exit in the window. Either the rest of it is inside the circle,
+        // so aim at its end, or the robot is off the path and the circle
+        // doesn't reach it, so head back to the closest point. Neither moves
+        // lookahead_segment, or an off-path robot would walk it down the path.
+        size_t target = distance_sq(end, x, y) <= r_sq ? end : cursor;
+        out_x = points[target].x;
+        out_y = points[target].y;
+        return true;
+    }
+
+   private:
+    double distance_sq(size_t i, double x, double y) const {
+        double dx = points[i].x - x;
+        double dy = points[i].y - y;
+        return dx * dx + dy * dy;
+    }
+
+    const P* points = nullptr;
+    size_t count = 0;
+    size_t cursor = 0;
+    size_t lookahead_segment = 0;
+};
+
+#endif //ROBOT_PATH_FOLLOWER
@@ -0,0 +1,80 @@
+#ifndef ROBOT_PATH_PLAN
+#define ROBOT_PATH_PLAN
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "path_follower.h"
+
+// Injecting and smoothing paths without allocating. EZ's
+// pid_odom_smooth_pp_set() passes the path through std::vectors by value
+// and smooths until a sweep changes it by less than the tolerance, all
+// before the robot moves. Here each path gets a fixed slot in a PathCache,
+// smoothing runs a few sweeps per call up to a cap, and the slot is found
+// again by its waypoints, so a path driven twice is only planned once.
+//
+// Pure math so the host benchmark runs the same code.
+// Benchmark: `make path_bench && ./bin/path_bench`
+
+const size_t PATH_MAX_WAYPOINTS = 32;
+const size_t PATH_MAX_POINTS = 1024; // 512 in at PATH_SPACING
+const size_t PATH_CACHE_SLOTS = 8;
+
+// EZ's smoothing constants, plus a cap so a long path can't run on
+struct PathSmoothing {
+    double weight_smooth = 0.75;
+    double weight_data = 0.03;
+    double tolerance = 0.0001; // total movement in one sweep, in
+    int max_sweeps = 200;
+
+    bool operator==(const PathSmoothing&) const = default;
+};
+
+struct PlannedPath {
+    uint32_t key = 0;
+    size_t count = 0;
+    PathPoint raw[PATH_MAX_POINTS]; // straight lines between the waypoints
+    PathPoint smooth[PATH_MAX_POINTS];
+    uint8_t segment[PATH_MAX_POINTS]; // the waypoint each point is headed for
+    int sweeps = 0;
+    double change = 0;                 // in the last sweep
+    std::atomic<bool> smoothed{false}; // smooth[] is done and won't change
+
+    // What it was planned from, to tell hash collisions apart
+    PathPoint waypoints[PATH_MAX_WAYPOINTS];
+    size_t waypoint_count = 0;
+    double spacing = 0;
+    PathSmoothing smoothing;
+    uint32_t used = 0; // PathCache's clock at the last plan()
+};
+
+uint32_t path_key(const PathPoint* waypoints, size_t count, double spacing, const PathSmoothing& smoothing);
+
+// Writes points every `spacing` inches along the waypoints into out, and
+// for each the index of the waypoint it's headed for into segment. Returns
+// how many, 0 if they don't fit in capacity.
+size_t inject_points(const PathPoint* waypoints, size_t count, PathPoint* out, uint8_t* segment, size_t capacity,
+                     double spacing = PATH_SPACING);
+
+// Up to `sweeps` more sweeps of EZ's smoothing over path.smooth. Returns
+// true once it's done, when a sweep moves the path less than the tolerance
+// or max_sweeps have run.
+bool path_smooth_step(PlannedPath& path, int sweeps);
+
+class PathCache {
+   public:
+    // The slot for these waypoints, injected and maybe not smoothed yet.
+    // A miss reuses the least recently planned slot that's done smoothing.
+    // nullptr if the path doesn't fit or every slot is still smoothing.
+    PlannedPath* plan(const PathPoint* waypoints, size_t count, const PathSmoothing& smoothing,
+                      double spacing = PATH_SPACING);
+
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+
+   private:
+    PlannedPath slots[PATH_CACHE_SLOTS];
+    uint32_t clock = 0;
+};
+
+#endif //ROBOT_PATH_PLAN
@@ -0,0 +1,145 @@
+#ifndef ROBOT_PID_BANK
+#define ROBOT_PID_BANK
+#include <cstdint>
+
+// PID_BANK_NEON computes the lanes with NEON intrinsics. It's off until it
+// has been built and checked against the vector version on the brain.
+#if defined(PID_BANK_NEON) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Many PIDs computed in one pass. ez::PID keeps each controller in its own
+// object of doubles, exit timers and a std::string name, and EZ's task
+// computes them one call at a time. A PidBank keeps each field in its own
+// float array, so a tick walks every controller's kp, then every target, and
+// so on, four at a time through GCC's vector extensions. Names sit in a
+// separate array the pass never touches.
+//
+// The math is ez::PID::compute()'s, per tick like EZ: the integral only
+// builds inside start_i and resets when the error changes sign, and the
+// derivative is the measurement's change since the last tick.
+//
+// Benchmark: `make pid_bench && ./bin/pid_bench`
+
+// N is how many controllers fit, in fours for the lanes
+template <int N = 16>
+class PidBank {
+   public:
+    static_assert(N % 4 == 0, "the bank is computed four slots at a time");
+
+    // The new controller's slot, -1 once the bank is full. name is only
+    // kept for printing.
+    int add(const char* p_name, double p_kp, double p_ki = 0, double p_kd = 0, double p_start_i = 0) {
+        if (count == N) return -1;
+        names[count] = p_name;
+        constants_set(count, p_kp, p_ki, p_kd, p_start_i);
+        variables_reset(count);
+        return count++;
+    }
+
+    void constants_set(int slot, double p_kp, double p_ki = 0, double p_kd = 0, double p_start_i = 0) {
+        kp[slot] = p_kp;
+        ki[slot] = p_ki;
+        kd[slot] = p_kd;
+        start_i[slot] = p_start_i;
+    }
+
+    void target_set(int slot, double p_target) { target[slot] = p_target; }
+    void variables_reset(int slot) {
+        integral[slot] = prev_error[slot] = prev_current[slot] = output[slot] = 0;
+    }
+
+    // The measurement for the next compute()
+    void input_set(int slot, double current) { input[slot] = current; }
+
+    // One tick of every controller
+    void compute() { compute_lanes((count + 3) & ~3); }
+
+    double output_get(int slot) const { return output[slot]; }
+    double error_get(int slot) const { return prev_error[slot]; }
+    double target_get(int slot) const { return target[slot]; }
+    const char* name_get(int slot) const { return names[slot]; }
+    int size() const { return count; }
+
+   private:
+    // Four controllers per step, ez::PID's ifs as lane masks
+#if defined(PID_BANK_NEON) && defined(__ARM_NEON)
+    void compute_lanes(int end) {
+        const float32x4_t zero = vdupq_n_f32(0);
+        for (int i = 0; i < end; i += 4) {
+            float32x4_t cur = vld1q_f32(input + i);
+            float32x4_t pe = vld1q_f32(prev_error + i);
+            float32x4_t integ = vld1q_f32(integral + i);
+            float32x4_t k_i = vld1q_f32(ki + i);
+
+            float32x4_t e = vsubq_f32(vld1q_f32(target + i), cur);
+            float32x4_t d = vsubq_f32(vld1q_f32(prev_current + i), cur);
+
+            uint32x4_t use_i = vmvnq_u32(vceqq_f32(k_i, zero));
+            uint32x4_t in_window = vandq_u32(use_i, vcltq_f32(vabsq_f32(e), vld1q_f32(start_i + i)));
+            integ = vbslq_f32(in_window, vaddq_f32(integ, e), integ);
+            uint32x4_t same_sign = vandq_u32(vceqq_u32(vcgtq_f32(e, zero), vcgtq_f32(pe, zero)),
+                                             vceqq_u32(vcltq_f32(e, zero), vcltq_f32(pe, zero)));
+            integ = vbslq_f32(vandq_u32(use_i, vmvnq_u32(same_sign)), zero, integ);
+
+            float32x4_t out = vmulq_f32(e, vld1q_f32(kp + i));
+            out = vmlaq_f32(out, integ, k_i);
+            out = vmlaq_f32(out, d, vld1q_f32(kd + i));
+
+            vst1q_f32(integral + i, integ);
+            vst1q_f32(output + i, out);
+            vst1q_f32(prev_current + i, cur);
+            vst1q_f32(prev_error + i, e);
+        }
+    }
+#else
+    // The same lanes through GCC's vector extensions, on the brain and in
+    // the sim and benches
+    typedef float f32x4 __attribute__((vector_size(16)));
+    typedef int32_t i32x4 __attribute__((vector_size(16)));
+
+    void compute_lanes(int end) {
+        const f32x4 zero = {};
+        for (int i = 0; i < end; i += 4) {
+            f32x4 cur = *(const f32x4*)(input + i);
+            f32x4 pe = *(const f32x4*)(prev_error + i);
+            f32x4 integ = *(const f32x4*)(integral + i);
+            f32x4 k_i = *(const f32x4*)(ki + i);
+
+            f32x4 e = *(const f32x4*)(target + i) - cur;
+            f32x4 d = *(const f32x4*)(prev_current + i) - cur;
+
+            i32x4 use_i = k_i != zero;
+            f32x4 abs_e = e < zero ? -e : e;
+            i32x4 in_window = use_i & (abs_e < *(const f32x4*)(start_i + i));
+            integ = in_window ? integ + e : integ;
+            i32x4 same_sign = ((e > zero) == (pe > zero)) & ((e < zero) == (pe < zero));
+            integ = (use_i & ~same_sign) ? zero : integ;
+
+            *(f32x4*)(integral + i) = integ;
+            *(f32x4*)(output + i) = e * *(const f32x4*)(kp + i) + integ * k_i + d * *(const f32x4*)(kd + i);
+            *(f32x4*)(prev_current + i) = cur;
+            *(f32x4*)(prev_error + i) = e;
+        }
+    }
+#endif
+
+    // Hot, one array per field. Slots past count stay zero, so the last
+    // four computes to nothing.
+    alignas(16) float kp[N] = {};
+    alignas(16) float ki[N] = {};
+    alignas(16) float kd[N] = {};
+    alignas(16) float start_i[N] = {};
+    alignas(16) float target[N] = {};
+    alignas(16) float input[N] = {};
+    alignas(16) float integral[N] = {};
+    alignas(16) float prev_error[N] = {};
+    alignas(16) float prev_current[N] = {};
+    alignas(16) float output[N] = {};
+    int count = 0;
+
+    // Cold
+    const char* names[N] = {};
+};
+
+#endif //ROBOT_PID_BANK
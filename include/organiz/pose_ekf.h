@@ -0,0 +1,88 @@
+#ifndef ROBOT_POSE_EKF
+#define ROBOT_POSE_EKF
+#include "matrix.h"
+
+// Extended Kalman filter over the drive's pose and speed. The tracking
+// wheels and IMU carry it every odom step, GPS fixes and distance sensor
+// ranges against known walls pull it back when they are available. Pure
+// math so the host tools can replay logs through the same filter.
+//
+// Same conventions as ez::pose: inches, 0 facing +y, clockwise positive.
+// Angles in the API are degrees, the state keeps radians.
+//
+// Benchmark: `make ekf_bench && ./bin/ekf_bench [tlm_NNN.bin]`
+
+struct EkfNoise {
+    double accel = 200;      // in/s^2, how fast v can change between steps
+    double alpha = 20;       // rad/s^2, same for omega
+    double wheel = 0.02;     // in, tracking wheel error per step
+    double wheel_turn = 0.2; // deg, tracking wheel turn error per step
+    double slip = 0.2;       // fraction of each step the wheels might slip or misread
+    double imu = 0.05;       // deg
+    double gps = 1.0;        // in, used when the fix doesn't give its own error
+    double range = 0.6;      // in, distance sensor up to 12 in, 5% of the reading past that
+    double gate = 3.0;       // reject a correction further than this many sigma out
+};
+
+// A straight piece of wall or field element a distance sensor can see
+struct FieldSegment {
+    double x1, y1, x2, y2;
+};
+
+// Where a distance sensor sits on the robot
+struct RangeMount {
+    double forward; // in ahead of the tracking center
+    double right;   // in right of the tracking center
+    double angle;   // deg, 0 looks forward, 90 looks right
+};
+
+// Distance from a sensor at (x, y, theta deg) along its ray to the closest
+// segment, -1 if the ray hits nothing
+double field_ray_cast(double x, double y, double theta, const RangeMount& mount, const FieldSegment* segments, int count);
+
+class PoseEkf {
+   public:
+    static const int N = 5; // x, y, theta, v, omega
+    using State = Matrix<N, 1>;
+    using Covariance = Matrix<N, N>;
+
+    EkfNoise noise;
+
+    void reset(double x, double y, double theta);
+
+    // One odom step: the tracking wheels moved the center d in and turned it
+    // d_theta deg over dt s. Corrects v and omega to the step's average, then
+    // moves the pose along that arc.
+    void step(double d, double d_theta, double dt);
+
+    // Absolute heading from the IMU, deg
+    void update_heading(double theta);
+
+    // Position fix, stddev in in (0 uses noise.gps). Returns false if gated
+    // out or any of them isn't finite, like a GPS with no fix.
+    bool update_position(double x, double y, double stddev = 0);
+
+    // Distance sensor reading in in. Uses the closest segment along the
+    // sensor's ray, returns false if the ray misses all of them or the
+    // reading is gated out (another robot or a game element in the way).
+    bool update_range(const RangeMount& mount, double reading, const FieldSegment* segments, int count);
+
+    double x() const { return s(0, 0); }
+    double y() const { return s(1, 0); }
+    double theta() const; // deg
+    double velocity() const { return s(3, 0); }
+    double omega() const; // deg/s
+    const Covariance& covariance() const { return P; }
+
+    // Expected reading for a sensor at the current pose, -1 if the ray hits nothing
+    double range_expected(const RangeMount& mount, const FieldSegment* segments, int count) const;
+
+   private:
+    template <int M>
+    bool correct(const Matrix<M, 1>& innovation, const Matrix<M, N>& H, const Matrix<M, M>& R, bool gated = true);
+
+    State s;
+    Covariance P;
+};
+
+#endif //ROBOT_POSE_EKF
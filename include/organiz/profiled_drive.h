@@ -0,0 +1,91 @@
+#ifndef ROBOT_PROFILED_DRIVE
+#define ROBOT_PROFILED_DRIVE
+#include "main.h"
+#include "motion_profile.h"
+#include "feedforward_fit.h"
+
+// Straight drives that follow a planned S-curve instead of EZ's slew ramp
+// and full-speed PID. Each side tracks the profile position with velocity
+// and acceleration feedforward, the heading PID keeps it straight, and the
+// last bit is handed to pid_drive_set() so the exit conditions are the same
+// as a normal drive. Turns and swings play the same kind of profile on the
+// wheels' arcs and hand off to pid_turn_set() and pid_swing_set().
+
+// Output (out of 127) = kS * sgn(v) + kV * v + kA * a + kP * position error
+struct ProfileGains {
+    double kS;
+    double kV; // per in/s
+    double kA; // per in/s^2
+    double kP; // per in
+};
+
+// Sets the same kS, kV and kA on both sides
+void drive_profile_constants_set(ProfileLimits limits, ProfileGains gains);
+
+// Per side feedforward, from drive characterization (include/organiz/characterize.h)
+void drive_profile_feedforward_set(Feedforward left, Feedforward right);
+
+// True once the feedforward came from characterization. Until then the
+// hand-set constants above are a guess, so routines and timelines drive
+// their profiled steps with pid_drive_set() and friends instead. Calling
+// drive_profiled() and the others directly always plays the profile.
+bool drive_profile_characterized();
+
+// Everything the two setters above hold, for the config store (include/organiz/config.h)
+struct DriveProfileConstants {
+    ProfileLimits limits;
+    Feedforward left;
+    Feedforward right;
+    double kP;
+    bool characterized;
+};
+
+DriveProfileConstants drive_profile_constants_get();
+void drive_profile_constants_set(const DriveProfileConstants& constants);
+
+// Blocks while the profile plays, then leaves chassis in a pid_drive_set()
+// toward the end point, so follow it with pid_wait() like any drive.
+// speed (out of 127) scales the velocity limit.
+void drive_profiled(double target, int speed);
+
+// target is a heading in deg like pid_turn_set() and pid_swing_set(). The
+// arcs come from chassis.drive_width_get(), the IMU finishes what scrub takes.
+// With no width set they're plain pid_turn_set() and pid_swing_set().
+void turn_profiled(double target, int speed);
+void swing_profiled(ez::e_swing type, double target, int speed);
+
+// The same motions a tick at a time, for code that can't block (the auton
+// timeline, include/organiz/timeline.h). Start one, then call update() every
+// ez::util::DELAY_TIME until it returns false, when EZ has the motion.
+class ProfiledMotion {
+   public:
+    void drive(double target, int speed);
+    void turn(double target, int speed);
+    void swing(ez::e_swing side, double target, int speed);
+
+    bool update();
+    bool active() const { return type != NONE; }
+    // Left to go, in for drives and deg for turns and swings
+    double remaining() const;
+
+   private:
+    enum Type : uint8_t { NONE, DRIVE, TURN, SWING };
+
+    void begin(double distance, int speed, double l_scale, double r_scale, bool hold_heading);
+    void handoff(const DriveSnapshot& snap);
+
+    Type type = NONE;
+    ez::e_swing side = ez::LEFT_SWING;
+    double target = 0;
+    int motion_speed = 0;
+    const MotionProfile* profile = nullptr;
+    // The left side moves l_scale and the right r_scale times the profile's position
+    double l_scale = 1;
+    double r_scale = 1;
+    bool hold_heading = false;
+    double l_start = 0;
+    double r_start = 0;
+    uint32_t start = 0;
+};
+
+#endif //ROBOT_PROFILED_DRIVE
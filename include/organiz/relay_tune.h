@@ -0,0 +1,62 @@
+#ifndef ROBOT_RELAY_TUNE
+#define ROBOT_RELAY_TUNE
+#include <cstdint>
+
+// Relay feedback tuning (Astrom-Hagglund). A relay drives the loop full
+// +-relay around its target, so it settles into a steady oscillation, and
+// the oscillation's period and size give the loop's ultimate gain and
+// period. Tuning rules turn those into PID gains. Pure math, the sim runs
+// the same experiment (`./bin/sim --autotune`).
+
+struct RelayResult {
+    double ku;        // ultimate gain, output per unit of error
+    double tu;        // ultimate period, s
+    double amplitude; // of the error oscillation
+    bool ok;          // false if the loop never settled into an oscillation
+};
+
+class RelayExperiment {
+   public:
+    // relay is the output size, hysteresis the error band where the relay
+    // doesn't switch (keeps sensor noise from chattering it). settle
+    // oscillations are thrown away before cycles are measured.
+    RelayExperiment(double relay, double hysteresis, int settle = 2, int cycles = 4);
+
+    // error is target - measurement, t in s. Returns the output to apply.
+    double update(double error, double t);
+    bool done() const { return measured >= cycles; }
+    RelayResult result() const;
+
+   private:
+    double relay;
+    double hysteresis;
+    int settle;
+    int cycles;
+
+    double output = 0;
+    int ups = 0;      // switches to +relay
+    int measured = 0; // full cycles since settling
+    double start = 0; // s, first measured switch up
+    double end = 0;
+    double error_max = 0;
+    double error_min = 0;
+};
+
+enum class TuneRule : uint8_t {
+    CLASSIC,        // Ziegler-Nichols, fast with a lot of overshoot
+    SOME_OVERSHOOT,
+    NO_OVERSHOOT,
+};
+
+const char* tune_rule_name(TuneRule rule);
+
+// Gains in ez::PID's units: the integral and derivative are per tick of dt
+// seconds (ez::util::DELAY_TIME), not per second
+struct TunedGains {
+    double kp;
+    double ki;
+    double kd;
+};
+TunedGains relay_gains(const RelayResult& result, TuneRule rule, double dt = 0.01);
+
+#endif //ROBOT_RELAY_TUNE
@@ -0,0 +1,53 @@
+#ifndef ROBOT_RELOCALIZE
+#define ROBOT_RELOCALIZE
+#include "main.h"
+#include "pose_ekf.h"
+
+// Relocalization against the field with pros::Distance sensors. Runs as the
+// odom task's corrector (odom_corrector_set), so every accepted reading goes
+// through the EKF and on into chassis.odom_pose_get() while the robot moves.
+//
+// Readings are time aligned: a distance sensor reports where the wall was a
+// little while ago, so each reading is checked against the pose from then
+// and carried forward by how much the expected range changed since. Until
+// the corrector has seen poses that far back, no readings are taken. Bad
+// readings (no object, low confidence, out of range, another robot in the
+// way) are dropped before they reach the filter or by its gate.
+//
+// The map is in odom coordinates, in. Set up the map and sensors before
+// reloc_enable(), from the auton or initialize(). See `./bin/sim --reloc`.
+
+const int RELOC_SENSORS_MAX = 4;
+const int RELOC_SEGMENTS_MAX = 32;
+const uint32_t RELOC_PERIOD = 35;    // ms, how often each sensor is read, about its update rate
+const uint32_t RELOC_LATENCY = 30;   // ms, default age of a reading when it is read
+const double RELOC_RANGE_MIN = 2;    // in, the sensor can't see closer
+const double RELOC_RANGE_MAX = 70;   // in, the sensor is only good to about 2 m
+const int RELOC_CONFIDENCE_MIN = 40; // of 63, only reported past 200 mm
+
+// Field perimeter in odom coordinates: (x, y) is where the robot starts on
+// the field measured from the field's center, facing the field's +y at 0.
+void reloc_map_walls(double start_x, double start_y);
+
+// Extra fixed field elements (stakes, the ladder), odom coordinates.
+void reloc_map_add(FieldSegment segment);
+void reloc_map_clear();
+
+void reloc_sensor_add(int8_t port, RangeMount mount);
+
+// Starts and stops correcting. mirrored uses the map flipped across x = 0,
+// for red autons written as mirror() of a blue one. Turns the EKF on.
+void reloc_enable(bool enable, bool mirrored = false);
+bool reloc_enabled();
+
+// How old a reading is when it is read, 0 uses readings as if they were current
+void reloc_latency_set(uint32_t ms);
+
+// Readings used and rejected since reloc_enable
+struct RelocStats {
+    int used;
+    int rejected;
+};
+RelocStats reloc_stats();
+
+#endif //ROBOT_RELOCALIZE
@@ -0,0 +1,51 @@
+#ifndef ROBOT_RING_BUFFER
+#define ROBOT_RING_BUFFER
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Lock-free single-producer / single-consumer queue. One task pushes, one
+// other task pops; neither ever blocks. When full, push() drops the new
+// item and counts it instead of stalling the producer.
+template <typename T, size_t N>
+class RingBuffer {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "RingBuffer capacity must be a power of two");
+
+public:
+    bool push(const T& item) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == N) {
+            dropped_count.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        items[h & (N - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Copies up to max items into out, returns how many were copied.
+    size_t pop(T* out, size_t max) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        uint32_t available = head.load(std::memory_order_acquire) - t;
+        size_t n = available < max ? available : max;
+        for (size_t i = 0; i < n; i++) {
+            out[i] = items[(t + i) & (N - 1)];
+        }
+        tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    size_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    uint32_t dropped() const { return dropped_count.load(std::memory_order_relaxed); }
+
+private:
+    T items[N];
+    std::atomic<uint32_t> head{0};
+    std::atomic<uint32_t> tail{0};
+    std::atomic<uint32_t> dropped_count{0};
+};
+
+#endif //ROBOT_RING_BUFFER
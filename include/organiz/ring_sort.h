@@ -0,0 +1,75 @@
+#ifndef ROBOT_RING_SORT
+#define ROBOT_RING_SORT
+#include <cstdint>
+
+// Ring color sorting math: classifying optical sensor samples, counting each
+// ring once, and following rings up the intake by the intake's encoder.
+// Pure math so the simulator (`./bin/sim --sort`) runs the same code.
+
+enum class RingColor : uint8_t { NONE, RED, BLUE };
+
+// One pros::Optical sample
+struct OpticalSample {
+    double hue;        // deg, 0 to 360
+    double saturation; // 0 to 1
+    int32_t proximity; // 0 to 255, higher is closer
+};
+
+struct RingClassifier {
+    double red_hue = 10;
+    double blue_hue = 215;
+    double hue_window = 35;      // deg either side of a ring's hue
+    double saturation_min = 0.4; // the field tiles and the hooks are grey
+    int32_t proximity_min = 110; // only something right in front of the sensor
+};
+
+RingColor ring_classify(const OpticalSample& sample, const RingClassifier& classifier = {});
+
+// Reports each ring once, on the confirm'th sample in a row with the same
+// color. The next ring is only counted after the sensor sees nothing for
+// release samples, so a ring sitting in front of the sensor isn't counted twice.
+class RingDetector {
+   public:
+    int confirm = 2;
+    int release = 2;
+
+    RingColor update(RingColor sample);
+    void reset();
+
+   private:
+    RingColor candidate = RingColor::NONE;
+    int same = 0;
+    int empty = 0;
+    bool counted = false;
+};
+
+// Rings between the sensor and the eject point, as the intake position each
+// was seen at. Positions are intake motor degrees.
+class RingTracker {
+   public:
+    static const int CAPACITY = 4; // more than fit between the sensor and the top
+
+    double travel = 700; // deg of intake from the sensor to where a ring flies off
+
+    // position is where the intake was when the sample was taken
+    bool push(RingColor color, double position);
+
+    // lead is how far the intake will move before an eject takes effect
+    // (velocity * latency). Returns the color of the ring that will be at
+    // the eject point by then and forgets it, NONE if no ring is there yet.
+    // Rings run back out the bottom of the intake are dropped.
+    RingColor update(double position, double lead);
+
+    int size() const { return count; }
+    void clear() { count = 0; }
+
+   private:
+    struct Ring {
+        RingColor color;
+        double seen_at;
+    };
+    Ring rings[CAPACITY];
+    int count = 0;
+};
+
+#endif //ROBOT_RING_SORT
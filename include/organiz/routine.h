@@ -0,0 +1,185 @@
+#ifndef ROBOT_ROUTINE
+#define ROBOT_ROUTINE
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "ring_sort.h"
+
+// Autons written as data. A routine is a constexpr std::array of Steps that
+// routine_run() plays on the chassis, and mirror() turns a blue routine into
+// the red one at compile time, so each pair only has one source.
+
+enum class StepType : uint8_t {
+    ANGLE,       // chassis.drive_angle_set(value)
+    DRIVE,       // chassis.pid_drive_set(value, speed, slew), or drive_profiled() if profiled and characterized
+    TURN,        // chassis.pid_turn_set(value, speed, slew)
+    SWING,       // chassis.pid_swing_set(side, value, speed, opposite_speed, slew)
+    WAIT,        // chassis.pid_wait()
+    DELAY,       // pros::delay(value)
+    INTAKE,      // intake_set(value)
+    INTAKE_STOP, // intake_set(0)
+    CLAMP,       // backClamp.set(value)
+    DOINKER,     // doinker.set(value)
+    RELOCALIZE,  // reloc_enable(value != 0), value < 0 uses the mirrored map
+    COLOR_SORT,  // color_sort_set(), value < 0 throws out red, > 0 blue
+};
+
+enum class StepSide : uint8_t { LEFT, RIGHT };
+
+// How a motion hands off to whatever comes after it, filled in by chain()
+enum class StepExit : uint8_t {
+    SETTLE, // pid_wait(), the robot stops
+    QUICK,  // pid_wait_quick(), leave as soon as the target is crossed
+    CHAIN,  // pid_wait_quick_chain(), aim past the target so the robot is still moving
+};
+
+struct Step {
+    StepType type;
+    double value = 0;
+    int speed = 0;
+    int opposite_speed = 0;
+    StepSide side = StepSide::LEFT;
+    bool slew = false;
+    bool wait = false; // wait for the motion right after this step
+    StepExit exit = StepExit::SETTLE;
+    bool profiled = false;
+
+    constexpr bool operator==(const Step&) const = default;
+};
+
+///
+// Step builders. Motions wait for the exit condition unless wrapped in no_wait().
+///
+constexpr Step step_angle(double deg) { return {StepType::ANGLE, deg}; }
+constexpr Step step_drive(double in, int speed, bool slew = false) { return {StepType::DRIVE, in, speed, 0, StepSide::LEFT, slew, true}; }
+// slew is for when it falls back to pid_drive_set(), the profile ramps up on its own
+constexpr Step step_drive_profiled(double in, int speed, bool slew = false) {
+    Step s = step_drive(in, speed, slew);
+    s.profiled = true;
+    return s;
+}
+constexpr Step step_turn(double deg, int speed, bool slew = false) { return {StepType::TURN, deg, speed, 0, StepSide::LEFT, slew, true}; }
+constexpr Step step_swing(StepSide side, double deg, int speed, int opposite_speed = 0, bool slew = false) {
+    return {StepType::SWING, deg, speed, opposite_speed, side, slew, true};
+}
+constexpr Step step_wait() { return {StepType::WAIT}; }
+constexpr Step step_delay(int ms) { return {StepType::DELAY, (double)ms}; }
+constexpr Step step_intake(int speed) { return {StepType::INTAKE, (double)speed}; }
+constexpr Step step_intake_stop() { return {StepType::INTAKE_STOP}; }
+constexpr Step step_clamp(bool down) { return {StepType::CLAMP, down ? 1.0 : 0.0}; }
+constexpr Step step_doinker(bool down) { return {StepType::DOINKER, down ? 1.0 : 0.0}; }
+// Doesn't wait, corrections run on the odom task until turned off
+constexpr Step step_relocalize(bool on) { return {StepType::RELOCALIZE, on ? 1.0 : 0.0}; }
+// The color to throw out, RingColor::NONE stops sorting
+constexpr Step step_color_sort(RingColor reject) {
+    return {StepType::COLOR_SORT, reject == RingColor::RED ? -1.0 : reject == RingColor::BLUE ? 1.0 : 0.0};
+}
+
+constexpr Step no_wait(Step s) {
+    s.wait = false;
+    return s;
+}
+
+///
+// Segment blending. chain() looks ahead from every waited motion to the next
+// queued one: same kind and same direction chains through at speed, any other
+// motion exits as soon as the target is crossed, and anything that needs the
+// robot still (delays, the clamp, explicit waits, the end) keeps pid_wait().
+// A motion entered while still moving skips its slew, the speed is already there.
+///
+
+// Don't chain into a segment shorter than this, the overshoot would eat it
+constexpr double CHAIN_MIN_DRIVE = 6;  // in
+constexpr double CHAIN_MIN_TURN = 15;  // deg
+
+constexpr bool step_is_motion(const Step& s) {
+    return s.type == StepType::DRIVE || s.type == StepType::TURN || s.type == StepType::SWING;
+}
+
+// Steps that need the robot stopped before they run
+constexpr bool step_needs_stop(const Step& s) {
+    return s.type == StepType::ANGLE || s.type == StepType::WAIT || s.type == StepType::DELAY || s.type == StepType::CLAMP;
+}
+
+// How motion s, size long (in or deg, signed), hands off to the motion next
+// when s ends facing heading
+constexpr StepExit chain_exit(const Step& s, double size, const Step& next, double heading) {
+    double next_size = next.type == StepType::DRIVE ? next.value : next.value - heading;
+    double next_min = next.type == StepType::DRIVE ? CHAIN_MIN_DRIVE : CHAIN_MIN_TURN;
+    bool same_way = next.type == s.type && (next_size > 0) == (size > 0);
+    bool long_enough = next_size > next_min || next_size < -next_min;
+    return same_way && long_enough ? StepExit::CHAIN : StepExit::QUICK;
+}
+
+template <size_t N>
+constexpr std::array<Step, N> chain(std::array<Step, N> steps) {
+    double heading = 0;
+    for (size_t i = 0; i < N; i++) {
+        Step& s = steps[i];
+        if (s.type == StepType::ANGLE) heading = s.value;
+        if (!step_is_motion(s)) continue;
+
+        // Signed size of this motion, and of the next one from where this one ends
+        double size = s.type == StepType::DRIVE ? s.value : s.value - heading;
+        if (s.type != StepType::DRIVE) heading = s.value;
+        if (!s.wait || s.speed == 0) continue;
+
+        const Step* next = nullptr;
+        for (size_t j = i + 1; j < N && next == nullptr; j++) {
+            if (step_is_motion(steps[j])) next = &steps[j];
+            else if (step_needs_stop(steps[j])) break;
+        }
+        if (next == nullptr || next->speed == 0) continue;
+
+        s.exit = chain_exit(s, size, *next, heading);
+    }
+    return steps;
+}
+
+///
+// Mirroring across the field's center line: headings flip sign, left
+// swings become right swings, relocalization uses the mirrored map and the
+// color sort throws out the other alliance's rings. Distances and
+// mechanisms are unchanged.
+///
+constexpr Step mirror(Step s) {
+    switch (s.type) {
+        case StepType::ANGLE:
+        case StepType::TURN:
+        case StepType::RELOCALIZE:
+        case StepType::COLOR_SORT:
+            s.value = -s.value;
+            break;
+        case StepType::SWING:
+            s.value = -s.value;
+            s.side = s.side == StepSide::LEFT ? StepSide::RIGHT : StepSide::LEFT;
+            break;
+        default:
+            break;
+    }
+    return s;
+}
+
+template <size_t N>
+constexpr std::array<Step, N> mirror(const std::array<Step, N>& steps) {
+    std::array<Step, N> out{};
+    for (size_t i = 0; i < N; i++) {
+        out[i] = mirror(steps[i]);
+    }
+    return out;
+}
+
+// Plays steps on the chassis, blocking like a hand written auton.
+void routine_run(const Step* steps, size_t count);
+
+// With chaining off every waited motion uses pid_wait(), to compare against
+void routine_chaining_set(bool on);
+bool routine_chaining_get();
+
+template <size_t N>
+void routine_run(const std::array<Step, N>& steps) {
+    routine_run(steps.data(), N);
+}
+
+#endif //ROBOT_ROUTINE
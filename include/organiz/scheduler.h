@@ -0,0 +1,65 @@
+#ifndef ROBOT_SCHEDULER
+#define ROBOT_SCHEDULER
+#include "main.h"
+
+// Timing stats for one periodic loop. Times are in microseconds.
+struct LoopStats {
+    uint32_t iterations = 0;
+    uint32_t deadline_misses = 0; // iterations that finished after the next release
+    uint32_t max_jitter_us = 0;   // worst wake-up lateness
+    double avg_jitter_us = 0;
+    uint32_t max_work_us = 0;     // worst time spent in the loop body
+};
+
+// Fixed-rate pacing for a loop that already has a task (opcontrol).
+// Call wait() at the bottom of the loop instead of pros::delay so the
+// period stays the same no matter how long the body took.
+class LoopTimer {
+public:
+    LoopTimer(const char* name, uint32_t period_ms);
+
+    void wait();
+
+    const LoopStats& stats() const { return loop_stats; }
+    // Clears stats and re-anchors the period on the next wait()
+    void stats_reset();
+    const char* name_get() const { return name; }
+    uint32_t period_get() const { return period; }
+
+private:
+    const char* name;
+    uint32_t period;
+    uint32_t release_ms = 0;
+    uint64_t wake_us = 0;
+    bool started = false;
+    LoopStats loop_stats;
+};
+
+// A LoopTimer with its own task, for background control loops.
+class PeriodicLoop {
+public:
+    PeriodicLoop(const char* name, uint32_t period_ms, std::function<void()> body,
+                 uint32_t priority = TASK_PRIORITY_DEFAULT);
+
+    // Creates the task on first call, resumes it after that.
+    void start();
+    void pause();
+    bool running() const { return is_running; }
+
+    LoopTimer timer;
+
+private:
+    std::function<void()> body;
+    uint32_t priority;
+    pros::Task* task = nullptr;
+    volatile bool is_running = false;
+};
+
+// Timers loop_stats_print() keeps track of, with room over the 12 in the
+// tree. Past this they still run, and the print says how many it's missing.
+const int LOOP_TIMERS_MAX = 24;
+
+// Prints every loop's stats to the terminal.
+void loop_stats_print();
+
+#endif //ROBOT_SCHEDULER
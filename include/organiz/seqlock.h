@@ -0,0 +1,42 @@
+#ifndef ROBOT_SEQLOCK
+#define ROBOT_SEQLOCK
+#include <atomic>
+#include <cstdint>
+
+// Single writer, many readers, nobody blocks. The writer fills the slot
+// readers aren't on and then flips the sequence, so a reader only retries
+// when the writer lapped it twice during one copy. Pure so the host can use it.
+//
+// seq is odd while a write is in progress; seq / 2 is the number of finished
+// writes and the newest finished value lives in slots[(seq / 2) & 1].
+template <typename T>
+class Seqlock {
+   public:
+    void write(const T& value) {
+        uint32_t s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slots[((s >> 1) + 1) & 1] = value;
+        seq.store(s + 2, std::memory_order_release);
+    }
+
+    T read() const {
+        T out;
+        while (true) {
+            uint32_t s = seq.load(std::memory_order_acquire);
+            out = slots[(s >> 1) & 1];
+            std::atomic_thread_fence(std::memory_order_acquire);
+            // Our slot is only written again once the writer is two writes on
+            if (seq.load(std::memory_order_relaxed) - (s & ~1u) < 3) return out;
+        }
+    }
+
+    // Number of finished writes
+    uint32_t version() const { return seq.load(std::memory_order_acquire) >> 1; }
+
+   private:
+    std::atomic<uint32_t> seq{0};
+    T slots[2] = {};
+};
+
+#endif //ROBOT_SEQLOCK
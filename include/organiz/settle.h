@@ -0,0 +1,79 @@
+#ifndef ROBOT_SETTLE
+#define ROBOT_SETTLE
+#include "main.h"
+#include "settle_predict.h"
+
+// Waiting out motions. pid_wait_settle() replaces chassis.pid_wait() for
+// motions that stop: with SettleMode::PREDICT it leaves as soon as the
+// fitted error is inside the loop's small exit error and staying there
+// (include/organiz/settle_predict.h), with EZ's timers still ending the
+// motion if the fit never settles. TIMERS is plain pid_wait(), to compare
+// against. Routines use it for every SETTLE exit and step_wait().
+//
+// Every wait is logged, so settle_stats_print() shows how long motions
+// took and, for predicted exits, how much of EZ's small_exit_time was left.
+
+enum class SettleMode : uint8_t { TIMERS, PREDICT };
+
+void settle_mode_set(SettleMode mode);
+SettleMode settle_mode_get();
+
+// Fit horizon, s. Longer is safer and slower.
+void settle_horizon_set(double horizon);
+double settle_horizon_get();
+
+// Blocks until the current drive, turn or swing is done
+SettleExit pid_wait_settle();
+
+// pid_wait_settle() a tick at a time, for code that can't block (the auton
+// timeline, include/organiz/timeline.h). start() right after setting the
+// motion, then update() every ez::util::DELAY_TIME, starting on the next
+// tick, until it stops returning RUNNING. Without PREDICT only the timers
+// end it. Logged like pid_wait_settle().
+class SettleWait {
+   public:
+    void start();
+    SettleExit update();
+    bool active() const { return running; }
+
+   private:
+    // A drive has a side per PID, turns and swings one
+    struct Side {
+        ez::PID* pid;
+        ExitTimers timers;
+        SettlePredictor predictor;
+        SettleExit exit;
+        double prev_error;
+    };
+
+    ez::e_mode mode = ez::DISABLE;
+    uint32_t start_ms = 0;
+    Side sides[2];
+    int n = 0;
+    bool first = true;
+    bool running = false;
+};
+
+struct MotionSettle {
+    ez::e_mode mode;
+    uint32_t ms;      // in the wait
+    double error;     // when it let go, in or deg
+    SettleExit exit;
+    int saved_ms;     // small_exit_time EZ still needed, for predicted exits
+};
+
+struct SettleStats {
+    int motions;
+    int predicted;
+    uint32_t ms;      // total in waits
+    int saved_ms;     // total small_exit_time skipped
+    double error_max; // largest |error| at a predicted exit
+};
+
+SettleStats settle_stats();
+const MotionSettle& settle_last();
+void settle_stats_reset();
+// The totals and the last motions to the terminal
+void settle_stats_print();
+
+#endif //ROBOT_SETTLE
@@ -0,0 +1,79 @@
+#ifndef ROBOT_SETTLE_PREDICT
+#define ROBOT_SETTLE_PREDICT
+#include <cstdint>
+
+// Deciding when a motion is done. ez::PID::exit_condition() only lets go
+// once the error has sat inside small_error for small_exit_time, so every
+// settled motion costs that long even when the robot stopped on target the
+// tick it got there. SettlePredictor fits a line to the last few errors and
+// calls the motion settled as soon as the fit, and where it's heading over
+// a short horizon, are inside the tolerance. ExitTimers are EZ's own timers
+// as the safety net for motions the fit never trusts. Pure math, the sim
+// runs the same code (`./bin/sim --settle`).
+
+enum class SettleExit : uint8_t {
+    RUNNING,
+    PREDICTED, // the fit says it's settled
+    SMALL,     // EZ's timers from here down
+    BIG,
+    VELOCITY,
+    MA,
+};
+
+const char* settle_exit_name(SettleExit exit);
+
+// ez::PID::exit_condition_'s fields, times in ms
+struct ExitLimits {
+    int small_exit_time;
+    double small_error;
+    int big_exit_time;
+    double big_error;
+    int velocity_exit_time;
+    int mA_timeout;
+};
+
+// The same counters as ez::PID::exit_condition(), a limit of 0 is off
+class ExitTimers {
+   public:
+    // velocity_zero is ez::PID's default, error change per tick
+    explicit ExitTimers(const ExitLimits& limits = {}, double velocity_zero = 0.05);
+
+    // velocity is the error's change since the last tick, dt in ms
+    SettleExit update(double error, double velocity, bool over_current, int dt);
+    int small_ms() const { return small; } // time so far inside small_error
+
+   private:
+    ExitLimits limits;
+    double velocity_zero;
+    int small = 0, big = 0, stopped = 0, current = 0;
+};
+
+class SettlePredictor {
+   public:
+    static const int WINDOW = 6; // samples in the fit, one per tick
+
+    // tolerance in the error's units, horizon in s
+    explicit SettlePredictor(double tolerance = 0, double horizon = 0.1);
+
+    // error is target - measurement, t in s. True once settled.
+    bool update(double error, double t);
+
+    double error_fit() const { return fit_error; }    // fitted error now
+    double velocity() const { return fit_velocity; }  // per s
+    double rms() const { return fit_rms; }            // of the samples about the fit
+    // s until the fitted error reaches the tolerance, 0 inside it and -1 if
+    // it isn't heading there
+    double time_to_settle() const;
+
+   private:
+    double tolerance;
+    double horizon;
+    double errors[WINDOW] = {};
+    double times[WINDOW] = {};
+    int count = 0; // samples so far, the window is full at WINDOW
+    double fit_error = 0;
+    double fit_velocity = 0;
+    double fit_rms = 0;
+};
+
+#endif //ROBOT_SETTLE_PREDICT
@@ -0,0 +1,27 @@
+#ifndef ROBOT_TELEMETRY
+#define ROBOT_TELEMETRY
+#include "main.h"
+#include "telemetry_format.h"
+
+// Records one TelemetrySample of the chassis every 10 ms into a lock-free
+// ring buffer. A low priority task drains it to /usd/tlm_NNN.bin, so the
+// capture side never touches the SD card.
+//
+// Decode on a computer with `make telemetry_csv && ./bin/telemetry_csv tlm_000.bin`
+
+// Opens the next free file, reusing the last one if it's still empty, and
+// writes the header. Finding the name takes a fopen() per recording on the
+// card, so it's done in initialize() instead of at the start of the auton.
+// Does nothing without an SD card.
+void telemetry_open();
+
+// Starts recording into the open file, with no SD card I/O of its own
+void telemetry_start();
+
+// Stops capture, writes whatever is left in the buffer, closes the file and
+// opens the next one.
+void telemetry_stop();
+
+bool telemetry_recording();
+
+#endif //ROBOT_TELEMETRY
@@ -0,0 +1,46 @@
+#ifndef ROBOT_TELEMETRY_FORMAT
+#define ROBOT_TELEMETRY_FORMAT
+#include <cstdint>
+
+// On-disk telemetry format, shared by the brain recorder and the host
+// decoder. A file is one TelemetryHeader followed by back-to-back
+// TelemetrySamples, little-endian, no padding between records.
+
+const uint32_t TELEMETRY_MAGIC = 0x54553138; // "81UT"
+const uint16_t TELEMETRY_VERSION = 1;
+
+struct TelemetryHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t sample_size;
+};
+
+// Flag bits in TelemetrySample::flags
+const uint8_t TELEMETRY_INTERFERED = 1 << 0;
+
+// One control tick of the drive
+struct TelemetrySample {
+    uint32_t time_ms;
+    uint8_t mode;         // ez::e_mode
+    uint8_t flags;
+    uint16_t reserved;
+    float target_left;    // in
+    float target_right;   // in
+    float target_heading; // deg
+    float x, y, theta;    // odom_pose_get()
+    float sensor_left;    // in
+    float sensor_right;   // in
+    float imu;            // deg
+    float mA_left;        // average of the side
+    float mA_right;
+    float out_left;       // PID outputs, -127 to 127
+    float out_right;
+    float out_turn;
+    float out_swing;
+    float out_heading;
+};
+
+static_assert(sizeof(TelemetryHeader) == 8, "TelemetryHeader layout changed");
+static_assert(sizeof(TelemetrySample) == 72, "TelemetrySample layout changed, bump TELEMETRY_VERSION");
+
+#endif //ROBOT_TELEMETRY_FORMAT
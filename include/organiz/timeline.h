@@ -0,0 +1,126 @@
+#ifndef ROBOT_TIMELINE
+#define ROBOT_TIMELINE
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "routine.h"
+
+// Autons as timelines instead of one serial script. Each node is a Step
+// plus when it starts: after another node finishes, together with it, or
+// once a motion gets within some distance of its target. timeline_run()
+// ticks every node on the calling task, so the intake can run while the
+// robot drives and the clamp can drop on the way in.
+//
+// Dependencies point back a number of nodes, so a timeline reads top to
+// bottom and mirror() keeps working. Motions end on pid_wait_settle()'s
+// exit (include/organiz/settle.h), or when a later motion takes over the
+// chassis, which is how a timeline chains: start the next motion within()
+// the last one, or let chain() pick the same exits routines get
+// (include/organiz/routine.h). Mechanism steps finish as they start, unless
+// for_ms() gives them a time, after which they're undone (the intake stops,
+// the clamp or doinker goes back).
+
+enum class NodeStart : uint8_t {
+    AFTER,  // once the node it depends on finishes, plus delay ms
+    WITH,   // once the node it depends on starts, plus delay ms
+    WITHIN, // once the motion it depends on is within distance of its target, or done
+};
+
+struct Node {
+    Step step;
+    uint8_t back = 1; // how many nodes back the dependency is, before the first node is the start
+    NodeStart start = NodeStart::AFTER;
+    double value = 0; // delay in ms, or the distance for WITHIN in in or deg
+    uint16_t duration = 0; // ms before a mechanism step is undone, 0 leaves it
+
+    constexpr bool operator==(const Node&) const = default;
+};
+
+// Nodes one timeline can hold, timeline_run() keeps state for each
+constexpr size_t TIMELINE_MAX = 64;
+
+///
+// Node builders
+///
+// After the node before, delay_ms later
+constexpr Node then(Step s, int delay_ms = 0) { return {s, 1, NodeStart::AFTER, (double)delay_ms}; }
+// Together with the node before, delay_ms later
+constexpr Node with(Step s, int delay_ms = 0) { return {s, 1, NodeStart::WITH, (double)delay_ms}; }
+// When the motion back nodes up is within distance (in or deg) of its target
+constexpr Node within(double distance, Step s, uint8_t back = 1) { return {s, back, NodeStart::WITHIN, distance}; }
+// Any node, depending on one further back
+constexpr Node back_to(uint8_t back, Node n) {
+    n.back = back;
+    return n;
+}
+// A mechanism step that's undone after ms
+constexpr Node for_ms(Node n, int ms) {
+    n.duration = ms;
+    return n;
+}
+
+constexpr Node mirror(Node n) {
+    n.step = mirror(n.step);
+    return n;
+}
+
+template <size_t N>
+constexpr std::array<Node, N> mirror(const std::array<Node, N>& nodes) {
+    std::array<Node, N> out{};
+    for (size_t i = 0; i < N; i++) {
+        out[i] = mirror(nodes[i]);
+    }
+    return out;
+}
+
+// chain() for timelines. A motion whose next motion starts right as it
+// finishes, then() on it with no delay, hands off like in a routine: CHAIN
+// aims past the target and QUICK leaves once it's crossed. Mechanism nodes
+// in between are fine unless they need the robot still.
+template <size_t N>
+constexpr std::array<Node, N> chain(std::array<Node, N> nodes) {
+    double heading = 0;
+    for (size_t i = 0; i < N; i++) {
+        Step& s = nodes[i].step;
+        if (s.type == StepType::ANGLE) heading = s.value;
+        if (!step_is_motion(s)) continue;
+
+        double size = s.type == StepType::DRIVE ? s.value : s.value - heading;
+        if (s.type != StepType::DRIVE) heading = s.value;
+        if (s.speed == 0) continue;
+
+        size_t next = N;
+        for (size_t j = i + 1; j < N && next == N; j++) {
+            if (step_is_motion(nodes[j].step)) next = j;
+            else if (step_needs_stop(nodes[j].step)) break;
+        }
+        if (next == N) continue;
+        const Node& n = nodes[next];
+        if (n.start != NodeStart::AFTER || n.back != next - i || n.value != 0 || n.step.speed == 0) continue;
+        s.exit = chain_exit(s, size, n.step, heading);
+    }
+    return nodes;
+}
+
+// Dependencies have to point at an earlier node, and within() at a motion
+template <size_t N>
+constexpr bool timeline_valid(const std::array<Node, N>& nodes) {
+    if (N > TIMELINE_MAX) return false;
+    for (size_t i = 0; i < N; i++) {
+        if (nodes[i].back == 0) return false;
+        if (nodes[i].start == NodeStart::WITHIN && (nodes[i].back > i || !step_is_motion(nodes[i - nodes[i].back].step)))
+            return false;
+    }
+    return true;
+}
+
+// Plays the nodes, blocking until every one of them has finished
+void timeline_run(const Node* nodes, size_t count);
+
+template <size_t N>
+void timeline_run(const std::array<Node, N>& nodes) {
+    timeline_run(nodes.data(), N);
+}
+
+#endif //ROBOT_TIMELINE
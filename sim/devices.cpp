@@ -0,0 +1,218 @@
+#include <algorithm>
+#include <cmath>
+
+#include "main.h"
+
+///
+// PROS stand-ins
+///
+namespace pros {
+void delay(std::uint32_t milliseconds) { sim::world().clock.advance(milliseconds); }
+std::uint32_t millis() { return sim::world().clock.millis(); }
+std::uint64_t micros() { return sim::world().clock.micros(); }
+
+Motor::Motor(std::int8_t port) : port(port) { sim::world().motors.push_back(&model); }
+
+std::int32_t Motor::move(std::int32_t voltage) {
+  model.command = ez::util::clamp(voltage, 127, -127) / 127.0;
+  return 1;
+}
+
+std::int32_t Motor::move_voltage(std::int32_t voltage) {
+  model.command = ez::util::clamp(voltage, 12000, -12000) / 12000.0;
+  return 1;
+}
+
+std::int32_t Motor::brake() {
+  model.command = 0.0;
+  return 1;
+}
+
+Rotation::Rotation(std::int8_t, Motor& joint) : joint(&joint.sim_model()) {}
+
+std::int32_t Rotation::get_position() const { return std::lround((joint->position - zero) * 100); }
+
+std::int32_t Rotation::reset() {
+  zero = joint->position;
+  return 1;
+}
+
+std::int32_t Motor::tare_position() {
+  zero = model.position;
+  return 1;
+}
+
+double Motor::get_position() const { return model.position - zero; }
+double Motor::get_actual_velocity() const { return model.rpm; }
+
+// z is counterclockwise positive like the real IMU
+imu_gyro_s_t Imu::get_gyro_rate() const { return {0, 0, -sim::world().drive.gyro_rate(), 0}; }
+
+static const double GPS_NOISE = 0.5;  // in
+static std::mt19937 gps_rng{18};
+static double gps_noise() { return std::normal_distribution<double>(0.0, GPS_NOISE)(gps_rng) / 39.37; }
+double Gps::get_position_x() const { return sim::world().drive.pose().x / 39.37 + gps_noise(); }
+double Gps::get_position_y() const { return sim::world().drive.pose().y / 39.37 + gps_noise(); }
+double Gps::get_error() const { return GPS_NOISE / 39.37; }
+
+// True poses of the last 64 ms, for readings taken in the past
+static sim::Pose truth_history[64];
+Distance::Distance(std::int8_t p_port) : port(p_port) {
+  static bool recording = false;
+  if (recording) return;
+  recording = true;
+  sim::world().clock.every(1, [] { truth_history[sim::world().clock.millis() % 64] = sim::world().drive.pose(); });
+}
+
+std::int32_t Distance::get() {
+  static std::mt19937 rng{33};
+  // A new reading every 33 ms whether or not anyone reads it
+  uint32_t now = sim::world().clock.millis();
+  uint32_t sample = now - now % 33;
+  if (sample == last_sample && value != 9999) return value;
+  last_sample = sample;
+
+  sim::Rangefinder r = sim::world().rangefinders[port];
+  std::vector<FieldSegment> segments;
+  for (const auto& w : sim::world().walls) segments.push_back({w[0], w[1], w[2], w[3]});
+  sim::Pose then = truth_history[(sample + 64 - 15) % 64];
+  double in = field_ray_cast(then.x, then.y, then.theta, {r.forward, r.right, r.angle}, segments.data(), segments.size());
+
+  double mm = in * 25.4;
+  if (in < 0 || mm > 2000) {
+    value = 9999;
+    confidence = 0;
+    return value;
+  }
+  mm += std::normal_distribution<double>(0.0, std::max(15.0, 0.05 * mm) / 2)(rng);
+  if (rng() % 20 == 0) mm *= 0.4;
+  value = (std::int32_t)std::max(0.0, mm);
+  confidence = value > 200 ? 63 : 0;
+  return value;
+}
+
+std::int32_t Optical::set_integration_time(double time) {
+  integration = std::max(3.0, time);
+  return 1;
+}
+
+void Optical::sample() {
+  static std::mt19937 rng{3};
+  std::int64_t now = sim::world().clock.millis();
+  std::int64_t at = now - now % (std::int64_t)integration;
+  if (at == last_sample) return;
+  last_sample = at;
+
+  const sim::IntakeModel& in = sim::world().intake;
+  double position = in.motor->position - in.motor->rpm * 6 * integration / 2000;
+  const sim::IntakeRing* ring = in.at_sensor(position);
+  auto normal = [](double mean, double stddev) { return std::normal_distribution<double>(mean, stddev)(rng); };
+  if (ring == nullptr) {
+    hue = std::fmod(normal(40, 30) + 360, 360);  // grey hooks under the LED
+    saturation = std::max(0.0, normal(0.15, 0.05));
+    proximity = (std::int32_t)std::max(0.0, normal(30, 10));
+  } else {
+    hue = std::fmod((ring->color == 1 ? normal(8, 6) : normal(212, 6)) + 360, 360);
+    saturation = std::min(1.0, normal(0.65, 0.08));
+    proximity = (std::int32_t)std::min(255.0, normal(190, 25));
+  }
+}
+
+double Optical::get_hue() {
+  sample();
+  return hue;
+}
+
+double Optical::get_saturation() {
+  sample();
+  return saturation;
+}
+
+std::int32_t Optical::get_proximity() {
+  sample();
+  return proximity;
+}
+
+std::int32_t Distance::get_confidence() { return confidence; }
+
+bool MotorGroup::left() const {
+  const std::vector<int>& left_ports = sim::world().left_ports;
+  return std::find(left_ports.begin(), left_ports.end(), ports[0]) != left_ports.end();
+}
+
+std::int32_t MotorGroup::move_voltage(std::int32_t voltage) const {
+  sim::DriveModel& drive = sim::world().drive;
+  double u = ez::util::clamp(voltage, 12000, -12000) / 12000.0;
+  if (left())
+    drive.command(u, drive.right_command());
+  else
+    drive.command(drive.left_command(), u);
+  return 1;
+}
+
+double MotorGroup::get_actual_velocity(std::uint8_t) const {
+  sim::DriveModel& drive = sim::world().drive;
+  double v = left() ? drive.left_velocity() : drive.right_velocity();
+  return v * 60 / (M_PI * drive.params.wheel_diameter);
+}
+
+std::int32_t MotorGroup::get_current_draw(std::uint8_t) const {
+  sim::DriveModel& drive = sim::world().drive;
+  return left() ? drive.left_current() : drive.right_current();
+}
+
+std::int32_t MotorGroup::get_voltage(std::uint8_t) const {
+  sim::DriveModel& drive = sim::world().drive;
+  return (left() ? drive.left_command() : drive.right_command()) * 12000;
+}
+}  // namespace pros
+
+///
+// Devices, mirroring src/organiz/robot_config.cpp
+///
+ez::Drive chassis(
+    DRIVE_LEFT_PORTS,   // Left Chassis Ports
+    DRIVE_RIGHT_PORTS,  // Right Chassis Ports
+    18,               // IMU Port
+    3.25,             // Wheel Diameter
+    1.66,             // External Gear Ratio
+    -16,              // Left Rotation Port
+    17                // Right Rotation Port
+);
+
+DriveIO drive_io;
+
+pros::Motor intake(15);
+pros::Optical color_checker(3);
+static bool intake_hooks = [] {
+  sim::world().intake.motor = &intake.sim_model();
+  return true;
+}();
+ez::Piston backClamp(2);
+ez::Piston doinker(8);
+ez::Piston intakePiston(5);
+pros::Motor ladybrown(2);
+pros::Rotation ladyBrownSensor(1, ladybrown);
+
+// Lady brown arm, the motor model is the joint: 100 rpm out of the gearing,
+// gravity needing about a quarter of full power to hold it level at 90 deg
+static bool ladybrown_arm = [] {
+  sim::MotorModel& arm = ladybrown.sim_model();
+  arm.free_rpm = 100;
+  arm.time_constant = 0.06;
+  arm.gravity = 400;
+  arm.level = 90;
+  return true;
+}();
+
+// Mirroring src/organiz/opcontrol.cpp, the sim arm's angles
+const ArmState lb_states[] = {
+    {"rest", 0},
+    {"load", 30},
+    {"score", 200},
+};
+ArmController lady_brown(ladybrown, ladyBrownSensor, lb_states, 3);
+
+// No brain screen, so no field view (src/organiz/field_view.cpp) to draw
+// paths on
+void field_view_path_set(const PathPoint* points, size_t count) {}
@@ -0,0 +1,686 @@
+#include <cmath>
+
+#include "sim_api.hpp"
+
+namespace ez {
+
+std::string exit_to_string(exit_output input) {
+  switch ((int)input) {
+    case RUNNING:
+      return "Running";
+    case SMALL_EXIT:
+      return "Small";
+    case BIG_EXIT:
+      return "Big";
+    case VELOCITY_EXIT:
+      return "Velocity";
+    case mA_EXIT:
+      return "mA";
+    case ERROR_NO_CONSTANTS:
+      return "Error: Exit condition constants not set!";
+    default:
+      return "Error: Out of bounds!";
+  }
+}
+
+int util::sgn(double input) {
+  if (input > 0) return 1;
+  if (input < 0) return -1;
+  return 0;
+}
+
+double util::clamp(double input, double max, double min) {
+  if (input > max) return max;
+  if (input < min) return min;
+  return input;
+}
+
+///
+// PID
+///
+PID::PID() {}
+
+PID::PID(double p, double i, double d, double start_i, std::string name) : name(name) {
+  constants_set(p, i, d, start_i);
+}
+
+void PID::constants_set(double p, double i, double d, double p_start_i) {
+  constants = {p, i, d, p_start_i};
+}
+
+void PID::exit_condition_set(int p_small_exit_time, double p_small_error, int p_big_exit_time, double p_big_error, int p_velocity_exit_time, int p_mA_timeout) {
+  exit = {p_small_exit_time, p_small_error, p_big_exit_time, p_big_error, p_velocity_exit_time, p_mA_timeout};
+}
+
+void PID::target_set(double input) { target = input; }
+double PID::target_get() { return target; }
+PID::Constants PID::constants_get() { return constants; }
+bool PID::constants_set_check() { return constants.kp != 0 || constants.ki != 0 || constants.kd != 0; }
+
+void PID::variables_reset() {
+  output = cur = error = prev_error = prev_current = integral = derivative = 0.0;
+}
+
+void PID::timers_reset() { i = j = k = l = 0; }
+
+double PID::compute(double current) {
+  cur = current;
+  error = target - cur;
+  derivative = prev_current - cur;
+
+  if (constants.ki != 0) {
+    if (std::fabs(error) < constants.start_i) integral += error;
+    if (util::sgn(error) != util::sgn(prev_error)) integral = 0;
+  }
+
+  output = (error * constants.kp) + (integral * constants.ki) + (derivative * constants.kd);
+
+  prev_current = cur;
+  prev_error = error;
+  return output;
+}
+
+exit_output PID::exit_condition(bool over_current) {
+  if (!(exit.small_error && exit.small_exit_time && exit.big_error && exit.big_exit_time && exit.velocity_exit_time && exit.mA_timeout))
+    return ERROR_NO_CONSTANTS;
+
+  if (std::fabs(error) <= exit.small_error) {
+    j += util::DELAY_TIME;
+    i = 0;
+    if (j > exit.small_exit_time) {
+      timers_reset();
+      return SMALL_EXIT;
+    }
+  } else {
+    j = 0;
+  }
+
+  if (std::fabs(error) <= exit.big_error) {
+    i += util::DELAY_TIME;
+    if (i > exit.big_exit_time) {
+      timers_reset();
+      return BIG_EXIT;
+    }
+  } else {
+    i = 0;
+  }
+
+  if (std::fabs(derivative) <= velocity_zero_main) {
+    k += util::DELAY_TIME;
+    if (k > exit.velocity_exit_time) {
+      timers_reset();
+      return VELOCITY_EXIT;
+    }
+  } else {
+    k = 0;
+  }
+
+  if (over_current) {
+    l += util::DELAY_TIME;
+    if (l > exit.mA_timeout) {
+      timers_reset();
+      return mA_EXIT;
+    }
+  } else {
+    l = 0;
+  }
+
+  return RUNNING;
+}
+
+///
+// Slew
+///
+void slew::constants_set(double distance, int minimum_speed) {
+  constants.distance_to_travel = distance;
+  constants.min_speed = minimum_speed;
+}
+
+void slew::initialize(bool enabled, double maximum_speed, double target, double current) {
+  is_enabled = enabled && constants.distance_to_travel > 0;
+  max_speed = maximum_speed;
+  sign = util::sgn(target - current);
+  start = current;
+}
+
+double slew::iterate(double current) {
+  if (!is_enabled) return max_speed;
+
+  // Linear ramp from min_speed to max_speed over distance_to_travel
+  double traveled = (current - start) * sign;
+  if (traveled >= constants.distance_to_travel) {
+    is_enabled = false;
+    return max_speed;
+  }
+  double ramp = constants.min_speed + (max_speed - constants.min_speed) * (std::fmax(traveled, 0.0) / constants.distance_to_travel);
+  return std::fmin(ramp, max_speed);
+}
+
+///
+// Piston
+///
+Piston::Piston(int input_port, bool default_state) : port(input_port), current(default_state) {}
+void Piston::set(bool input) { current = input; }
+bool Piston::get() { return current; }
+
+void Piston::button_toggle(int toggle) {
+  if (toggle && !last_press) set(!current);
+  last_press = toggle;
+}
+
+void Piston::buttons(int active, int deactive) {
+  if (active && !current)
+    set(true);
+  else if (deactive && current)
+    set(false);
+}
+
+///
+// Drive
+///
+Drive::Drive(std::vector<int> left_motor_ports, std::vector<int> right_motor_ports, int imu_port, double wheel_diameter, double ratio, int left_rotation_port, int right_rotation_port)
+    : wheel_diameter(wheel_diameter), ratio(ratio) {
+  sim::World& w = sim::world();
+  w.left_ports = left_motor_ports;
+  for (int port : left_motor_ports) left_motors.push_back(pros::MotorGroup({(std::int8_t)port}));
+  for (int port : right_motor_ports) right_motors.push_back(pros::MotorGroup({(std::int8_t)port}));
+  w.clock.every(util::DELAY_TIME, [this] { ez_auto_task(); });
+  w.on_reset.push_back([this] { sim_reset(); });
+  sim_reset();
+}
+
+void Drive::sim_reset() {
+  for (PID* p : {&headingPID, &turnPID, &leftPID, &rightPID, &swingPID, &xyPID}) {
+    p->variables_reset();
+    p->timers_reset();
+    p->target_set(0);
+  }
+  mode = DISABLE;
+  interfered = false;
+  heading_on = true;
+  last_left = last_right = 0;
+  pp_path.clear();
+  pp_left.clear();
+  pp_index = 0;
+  l_zero = r_zero = imu_zero = 0;
+  odom = {0, 0, 0};
+  odom_l = odom_r = odom_t = 0;
+  sim::world().drive.command(0, 0);
+}
+
+void Drive::pid_heading_constants_set(double p, double i, double d, double p_start_i) {
+  headingPID.constants_set(p, i, d, p_start_i);
+}
+
+void Drive::pid_drive_constants_set(double p, double i, double d, double p_start_i) {
+  pid_drive_constants_forward_set(p, i, d, p_start_i);
+  pid_drive_constants_backward_set(p, i, d, p_start_i);
+}
+
+void Drive::pid_drive_constants_forward_set(double p, double i, double d, double p_start_i) {
+  forward_drivePID.constants_set(p, i, d, p_start_i);
+}
+
+void Drive::pid_drive_constants_backward_set(double p, double i, double d, double p_start_i) {
+  backward_drivePID.constants_set(p, i, d, p_start_i);
+}
+
+void Drive::pid_turn_constants_set(double p, double i, double d, double p_start_i) {
+  turnPID.constants_set(p, i, d, p_start_i);
+}
+
+void Drive::pid_swing_constants_set(double p, double i, double d, double p_start_i) {
+  forward_swingPID.constants_set(p, i, d, p_start_i);
+  backward_swingPID.constants_set(p, i, d, p_start_i);
+  swingPID.constants_set(p, i, d, p_start_i);
+}
+
+void Drive::pid_swing_constants_forward_set(double p, double i, double d, double p_start_i) {
+  forward_swingPID.constants_set(p, i, d, p_start_i);
+}
+
+void Drive::pid_swing_constants_backward_set(double p, double i, double d, double p_start_i) {
+  backward_swingPID.constants_set(p, i, d, p_start_i);
+}
+
+void Drive::pid_drive_exit_condition_set(int p_small_exit_time, double p_small_error, int p_big_exit_time, double p_big_error, int p_velocity_exit_time, int p_mA_timeout, bool use_imu) {
+  leftPID.exit_condition_set(p_small_exit_time, p_small_error, p_big_exit_time, p_big_error, p_velocity_exit_time, p_mA_timeout);
+  rightPID.exit_condition_set(p_small_exit_time, p_small_error, p_big_exit_time, p_big_error, p_velocity_exit_time, p_mA_timeout);
+}
+
+void Drive::pid_turn_exit_condition_set(int p_small_exit_time, double p_small_error, int p_big_exit_time, double p_big_error, int p_velocity_exit_time, int p_mA_timeout, bool use_imu) {
+  turnPID.exit_condition_set(p_small_exit_time, p_small_error, p_big_exit_time, p_big_error, p_velocity_exit_time, p_mA_timeout);
+}
+
+void Drive::pid_swing_exit_condition_set(int p_small_exit_time, double p_small_error, int p_big_exit_time, double p_big_error, int p_velocity_exit_time, int p_mA_timeout, bool use_imu) {
+  swingPID.exit_condition_set(p_small_exit_time, p_small_error, p_big_exit_time, p_big_error, p_velocity_exit_time, p_mA_timeout);
+}
+
+void Drive::pid_drive_exit_condition_set(okapi::QTime p_small_exit_time, okapi::QLength p_small_error, okapi::QTime p_big_exit_time, okapi::QLength p_big_error, okapi::QTime p_velocity_exit_time, okapi::QTime p_mA_timeout, bool use_imu) {
+  pid_drive_exit_condition_set(p_small_exit_time.ms, p_small_error.in, p_big_exit_time.ms, p_big_error.in, p_velocity_exit_time.ms, p_mA_timeout.ms, use_imu);
+}
+
+void Drive::pid_turn_exit_condition_set(okapi::QTime p_small_exit_time, okapi::QAngle p_small_error, okapi::QTime p_big_exit_time, okapi::QAngle p_big_error, okapi::QTime p_velocity_exit_time, okapi::QTime p_mA_timeout, bool use_imu) {
+  pid_turn_exit_condition_set(p_small_exit_time.ms, p_small_error.deg, p_big_exit_time.ms, p_big_error.deg, p_velocity_exit_time.ms, p_mA_timeout.ms, use_imu);
+}
+
+void Drive::pid_swing_exit_condition_set(okapi::QTime p_small_exit_time, okapi::QAngle p_small_error, okapi::QTime p_big_exit_time, okapi::QAngle p_big_error, okapi::QTime p_velocity_exit_time, okapi::QTime p_mA_timeout, bool use_imu) {
+  pid_swing_exit_condition_set(p_small_exit_time.ms, p_small_error.deg, p_big_exit_time.ms, p_big_error.deg, p_velocity_exit_time.ms, p_mA_timeout.ms, use_imu);
+}
+
+void Drive::slew_drive_constants_set(okapi::QLength distance, int min_speed) {
+  slew_forward.constants_set(distance.in, min_speed);
+  slew_backward.constants_set(distance.in, min_speed);
+}
+
+void Drive::slew_turn_constants_set(okapi::QAngle distance, int min_speed) {
+  slew_turn.constants_set(distance.deg, min_speed);
+}
+
+void Drive::slew_swing_constants_set(okapi::QAngle distance, int min_speed) {
+  slew_swing_constants_forward_set(distance, min_speed);
+  slew_swing_constants_backward_set(distance, min_speed);
+}
+
+void Drive::slew_drive_constants_forward_set(okapi::QLength distance, int min_speed) {
+  slew_forward.constants_set(distance.in, min_speed);
+}
+
+void Drive::slew_drive_constants_backward_set(okapi::QLength distance, int min_speed) {
+  slew_backward.constants_set(distance.in, min_speed);
+}
+
+void Drive::slew_swing_constants_forward_set(okapi::QAngle distance, int min_speed) {
+  slew_swing_forward.constants_set(distance.deg, min_speed);
+}
+
+void Drive::slew_swing_constants_backward_set(okapi::QAngle distance, int min_speed) {
+  slew_swing_backward.constants_set(distance.deg, min_speed);
+}
+
+void Drive::pid_speed_max_set(int speed) {
+  max_speed = std::abs(speed);
+  slew_left.speed_max_set(max_speed);
+  slew_right.speed_max_set(max_speed);
+  slew_turn.speed_max_set(max_speed);
+  slew_swing.speed_max_set(max_speed);
+}
+
+///
+// Motions
+///
+void Drive::pid_drive_set(double target, int speed, bool slew_on, bool toggle_heading) {
+  bool forward = target >= 0;
+  PID::Constants c = forward ? forward_drivePID.constants : backward_drivePID.constants;
+  leftPID.constants = c;
+  rightPID.constants = c;
+
+  l_start = drive_sensor_left();
+  r_start = drive_sensor_right();
+  motion_target = target;
+  leftPID.target_set(l_start + target);
+  rightPID.target_set(r_start + target);
+  leftPID.timers_reset();
+  rightPID.timers_reset();
+  leftPID.prev_current = l_start;
+  rightPID.prev_current = r_start;
+
+  heading_on = toggle_heading;
+  pid_speed_max_set(speed);
+
+  ez::slew& s = forward ? slew_forward : slew_backward;
+  slew_left.constants = s.constants;
+  slew_right.constants = s.constants;
+  slew_left.initialize(slew_on, max_speed, l_start + target, l_start);
+  slew_right.initialize(slew_on, max_speed, r_start + target, r_start);
+
+  mode = DRIVE;
+}
+
+void Drive::pid_drive_set(okapi::QLength p_target, int speed, bool slew_on, bool toggle_heading) {
+  pid_drive_set(p_target.in, speed, slew_on, toggle_heading);
+}
+
+void Drive::pid_turn_set(double target, int speed, bool slew_on) {
+  double current = drive_imu_get();
+  motion_target = target;
+  turnPID.target_set(target);
+  turnPID.timers_reset();
+  turnPID.prev_current = current;
+  headingPID.target_set(target);
+  pid_speed_max_set(speed);
+  slew_turn.initialize(slew_on, max_speed, target, current);
+  mode = TURN;
+}
+
+void Drive::pid_turn_set(okapi::QAngle p_target, int speed, bool slew_on) {
+  pid_turn_set(p_target.deg, speed, slew_on);
+}
+
+void Drive::pid_swing_set(e_swing type, double target, int speed, int opposite_speed, bool slew_on) {
+  double current = drive_imu_get();
+  // The swinging side drives forward when it turns the robot toward the target
+  bool forward = (type == LEFT_SWING) == (target >= current);
+  swingPID.constants = forward ? forward_swingPID.constants : backward_swingPID.constants;
+  slew_swing.constants = forward ? slew_swing_forward.constants : slew_swing_backward.constants;
+
+  current_swing = type;
+  swing_opposite_speed = opposite_speed;
+  motion_target = target;
+  swingPID.target_set(target);
+  swingPID.timers_reset();
+  swingPID.prev_current = current;
+  headingPID.target_set(target);
+  pid_speed_max_set(speed);
+  slew_swing.initialize(slew_on, max_speed, target, current);
+  mode = SWING;
+}
+
+void Drive::pid_swing_set(e_swing type, double target, int speed, bool slew_on) {
+  pid_swing_set(type, target, speed, 0, slew_on);
+}
+
+void Drive::pid_swing_set(e_swing type, okapi::QAngle p_target, int speed, int opposite_speed, bool slew_on) {
+  pid_swing_set(type, p_target.deg, speed, opposite_speed, slew_on);
+}
+
+void Drive::pid_swing_set(e_swing type, okapi::QAngle p_target, int speed, bool slew_on) {
+  pid_swing_set(type, p_target.deg, speed, 0, slew_on);
+}
+
+void Drive::pid_targets_reset() {
+  headingPID.target_set(0);
+  leftPID.target_set(0);
+  rightPID.target_set(0);
+  turnPID.target_set(0);
+  swingPID.target_set(0);
+}
+
+void Drive::pid_odom_pp_set(std::vector<ez::odom> imovements, bool slew_on) {
+  if (imovements.empty()) return;
+  pp_path = std::move(imovements);
+  pp_left.assign(pp_path.size(), 0.0);
+  for (size_t i = pp_path.size() - 1; i-- > 0;) {
+    const pose& a = pp_path[i].target;
+    const pose& b = pp_path[i + 1].target;
+    pp_left[i] = pp_left[i + 1] + std::hypot(b.x - a.x, b.y - a.y);
+  }
+  pp_index = 0;
+
+  xyPID.constants = forward_drivePID.constants;
+  xyPID.exit = leftPID.exit;
+  xyPID.target_set(0);
+  xyPID.timers_reset();
+  xyPID.prev_current = -pp_left[0];
+  headingPID.target_set(drive_imu_get());
+  pid_speed_max_set(pp_path[0].max_xy_speed);
+  mode = PURE_PURSUIT;
+}
+
+void Drive::pid_odom_injected_pp_set(std::vector<ez::odom> imovements, bool slew_on) {
+  if (imovements.empty()) return;
+  imovements.insert(imovements.begin(), {{odom.x, odom.y, ANGLE_NOT_SET}, imovements[0].drive_direction, imovements[0].max_xy_speed});
+  pid_odom_pp_set(std::move(imovements), slew_on);
+}
+
+///
+// Waits
+///
+exit_output Drive::wait_exit() {
+  if (mode == DRIVE) {
+    exit_output left_exit = RUNNING;
+    exit_output right_exit = RUNNING;
+    while (left_exit == RUNNING || right_exit == RUNNING) {
+      left_exit = left_exit != RUNNING ? left_exit : leftPID.exit_condition(drive_current_left_over());
+      right_exit = right_exit != RUNNING ? right_exit : rightPID.exit_condition(drive_current_right_over());
+      pros::delay(util::DELAY_TIME);
+    }
+    return left_exit == SMALL_EXIT || left_exit == BIG_EXIT ? right_exit : left_exit;
+  }
+
+  if (mode == PURE_PURSUIT) {
+    exit_output exit = RUNNING;
+    while (exit == RUNNING) {
+      exit = xyPID.exit_condition(drive_current_left_over() || drive_current_right_over());
+      pros::delay(util::DELAY_TIME);
+    }
+    return exit;
+  }
+
+  PID* pid = mode == TURN ? &turnPID : mode == SWING ? &swingPID : nullptr;
+  if (!pid) return RUNNING;
+  bool swinging_left = current_swing == LEFT_SWING;
+  exit_output exit = RUNNING;
+  while (exit == RUNNING) {
+    bool over = mode == TURN ? drive_current_left_over() || drive_current_right_over()
+                             : (swinging_left ? drive_current_left_over() : drive_current_right_over());
+    exit = pid->exit_condition(over);
+    pros::delay(util::DELAY_TIME);
+  }
+  return exit;
+}
+
+void Drive::pid_wait() {
+  exit_output exit = wait_exit();
+  interfered = exit == mA_EXIT || exit == VELOCITY_EXIT;
+}
+
+void Drive::pid_wait_until(double target) {
+  if (mode == DRIVE) {
+    double l_tar = l_start + target;
+    double r_tar = r_start + target;
+    int l_sgn = util::sgn(l_tar - drive_sensor_left());
+    int r_sgn = util::sgn(r_tar - drive_sensor_right());
+    exit_output left_exit = RUNNING;
+    exit_output right_exit = RUNNING;
+    while (util::sgn(l_tar - drive_sensor_left()) == l_sgn || util::sgn(r_tar - drive_sensor_right()) == r_sgn) {
+      if (left_exit != RUNNING && right_exit != RUNNING) {
+        interfered = left_exit == mA_EXIT || left_exit == VELOCITY_EXIT || right_exit == mA_EXIT || right_exit == VELOCITY_EXIT;
+        return;
+      }
+      left_exit = left_exit != RUNNING ? left_exit : leftPID.exit_condition(drive_current_left_over());
+      right_exit = right_exit != RUNNING ? right_exit : rightPID.exit_condition(drive_current_right_over());
+      pros::delay(util::DELAY_TIME);
+    }
+    return;
+  }
+
+  PID* pid = mode == TURN ? &turnPID : mode == SWING ? &swingPID : nullptr;
+  if (!pid) return;
+  int sgn = util::sgn(target - drive_imu_get());
+  exit_output exit = RUNNING;
+  while (util::sgn(target - drive_imu_get()) == sgn) {
+    if (exit != RUNNING) {
+      interfered = exit == mA_EXIT || exit == VELOCITY_EXIT;
+      return;
+    }
+    exit = pid->exit_condition(drive_current_left_over() || drive_current_right_over());
+    pros::delay(util::DELAY_TIME);
+  }
+}
+
+void Drive::pid_wait_quick() {
+  pid_wait_until(motion_target);
+}
+
+void Drive::pid_wait_quick_chain() {
+  // Push the target past where we want to be so the robot is still moving
+  // when it crosses the real target
+  if (mode == DRIVE) {
+    double chain = drive_chain * util::sgn(motion_target);
+    leftPID.target_set(leftPID.target_get() + chain);
+    rightPID.target_set(rightPID.target_get() + chain);
+  } else if (mode == TURN) {
+    turnPID.target_set(turnPID.target_get() + turn_chain * util::sgn(motion_target - drive_imu_get()));
+  } else if (mode == SWING) {
+    swingPID.target_set(swingPID.target_get() + swing_chain * util::sgn(motion_target - drive_imu_get()));
+  }
+  pid_wait_until(motion_target);
+}
+
+///
+// Drive and sensors
+///
+void Drive::drive_set(int left, int right) {
+  last_left = util::clamp(left, 127, -127);
+  last_right = util::clamp(right, 127, -127);
+  sim::world().drive.command(last_left / 127.0, last_right / 127.0);
+}
+
+void Drive::drive_mode_set(e_mode p_mode, bool stop_drive) {
+  mode = p_mode;
+  if (mode == DISABLE && stop_drive) drive_set(0, 0);
+}
+
+void Drive::drive_brake_set(pros::motor_brake_mode_e_t brake_type) {
+  brake = brake_type;
+  sim::world().drive.hold_set(brake_type != pros::E_MOTOR_BRAKE_COAST);
+}
+
+void Drive::drive_angle_set(double angle) {
+  // On the field this declares which way the robot was placed, so the
+  // sim turns the ground-truth robot to match
+  sim::DriveModel& model = sim::world().drive;
+  model.heading_set(angle);
+  imu_zero = model.heading() - angle;
+  odom_t = angle;
+  odom.theta = angle;
+  headingPID.target_set(angle);
+}
+
+void Drive::drive_sensor_reset() {
+  l_zero += drive_sensor_left();
+  r_zero += drive_sensor_right();
+  odom_l = odom_r = 0;
+}
+
+void Drive::drive_imu_reset(double new_heading) {
+  imu_zero = sim::world().drive.heading() - new_heading;
+  odom_t = new_heading;
+}
+
+double Drive::drive_sensor_left() { return sim::world().drive.left_position() - l_zero; }
+double Drive::drive_sensor_right() { return sim::world().drive.right_position() - r_zero; }
+double Drive::drive_imu_get() { return sim::world().drive.heading() - imu_zero; }
+
+// Wheel rpm, like the motor velocity EZ reads
+int Drive::drive_velocity_left() { return sim::world().drive.left_velocity() * 60.0 / (M_PI * wheel_diameter); }
+int Drive::drive_velocity_right() { return sim::world().drive.right_velocity() * 60.0 / (M_PI * wheel_diameter); }
+
+double Drive::drive_mA_left() { return sim::world().drive.left_current(); }
+double Drive::drive_mA_right() { return sim::world().drive.right_current(); }
+bool Drive::drive_current_left_over() { return drive_mA_left() >= CURRENT_MA * 0.95; }
+bool Drive::drive_current_right_over() { return drive_mA_right() >= CURRENT_MA * 0.95; }
+
+void Drive::odom_xyt_set(double x, double y, double t) {
+  odom = {x, y, t};
+  imu_zero = sim::world().drive.heading() - t;
+  odom_t = t;
+}
+
+void Drive::odom_xy_set(double x, double y) {
+  odom.x = x;
+  odom.y = y;
+}
+
+void Drive::odom_theta_set(double a) { odom_xyt_set(odom.x, odom.y, a); }
+
+///
+// Control task
+///
+void Drive::ez_auto_task() {
+  odom_update();
+  switch (mode) {
+    case DRIVE:
+      drive_pid_task();
+      break;
+    case TURN:
+      turn_pid_task();
+      break;
+    case SWING:
+      swing_pid_task();
+      break;
+    case PURE_PURSUIT:
+      pp_task();
+      break;
+    default:
+      break;
+  }
+}
+
+void Drive::odom_update() {
+  double l = drive_sensor_left(), r = drive_sensor_right(), t = drive_imu_get();
+  double dl = l - odom_l, dr = r - odom_r;
+  double dtheta = (t - odom_t) * M_PI / 180.0;
+  double ds = (dl + dr) / 2.0;
+  double chord = std::fabs(dtheta) < 1e-9 ? ds : 2.0 * ds / dtheta * std::sin(dtheta / 2.0);
+  double mid = odom_t * M_PI / 180.0 + dtheta / 2.0;
+  odom.x += chord * std::sin(mid);
+  odom.y += chord * std::cos(mid);
+  odom.theta = t;
+  odom_l = l;
+  odom_r = r;
+  odom_t = t;
+}
+
+void Drive::drive_pid_task() {
+  leftPID.compute(drive_sensor_left());
+  rightPID.compute(drive_sensor_right());
+  headingPID.compute(drive_imu_get());
+
+  double l_slew_out = slew_left.iterate(drive_sensor_left());
+  double r_slew_out = slew_right.iterate(drive_sensor_right());
+
+  double l_drive_out = util::clamp(leftPID.output, l_slew_out, -l_slew_out);
+  double r_drive_out = util::clamp(rightPID.output, r_slew_out, -r_slew_out);
+
+  double gyro_out = heading_on ? headingPID.output : 0;
+  drive_set(l_drive_out + gyro_out, r_drive_out - gyro_out);
+}
+
+void Drive::turn_pid_task() {
+  double imu = drive_imu_get();
+  turnPID.compute(imu);
+  double max = slew_turn.iterate(imu);
+  double out = util::clamp(turnPID.output, max, -max);
+  drive_set(out, -out);
+}
+
+void Drive::swing_pid_task() {
+  double imu = drive_imu_get();
+  swingPID.compute(imu);
+  double max = slew_swing.iterate(imu);
+  double swing_out = util::clamp(swingPID.output, max, -max);
+  // Opposite side scales with the swinging side so wide arcs stay wide
+  double opposite_out = max_speed != 0 ? swing_opposite_speed * (swing_out / max_speed) : 0;
+  if (current_swing == LEFT_SWING)
+    drive_set(swing_out, opposite_out);
+  else
+    drive_set(opposite_out, -swing_out);
+}
+
+void Drive::pp_task() {
+  // The first point past the look ahead, the last one once it's inside it
+  auto away = [this](size_t i) { return std::hypot(pp_path[i].target.x - odom.x, pp_path[i].target.y - odom.y); };
+  while (pp_index + 1 < pp_path.size() && away(pp_index) < look_ahead) pp_index++;
+  const ez::odom& p = pp_path[pp_index];
+  int dir = p.drive_direction == REV ? -1 : 1;
+  double dx = p.target.x - odom.x, dy = p.target.y - odom.y;
+  double t = odom.theta * M_PI / 180.0;
+
+  // Close to the end the bearing swings around, so the heading holds there
+  if (pp_index + 1 < pp_path.size() || away(pp_index) > look_ahead / 2) {
+    double bearing = std::atan2(dx, dy) * 180.0 / M_PI + (dir < 0 ? 180.0 : 0.0);
+    headingPID.target_set(odom.theta + std::remainder(bearing - odom.theta, 360.0));
+  }
+  headingPID.compute(odom.theta);
+
+  // What's left, along the way the robot points so it goes negative past the end
+  double left = dir * (dx * std::sin(t) + dy * std::cos(t)) + pp_left[pp_index];
+  xyPID.compute(-left);
+  pid_speed_max_set(p.max_xy_speed);
+  double xy_out = util::clamp(xyPID.output, max_speed, -max_speed) * dir;
+  drive_set(xy_out + headingPID.output, xy_out - headingPID.output);
+}
+
+}  // namespace ez
@@ -0,0 +1,59 @@
+#pragma once
+
+/**
+ * Host stand-in for include/main.h.
+ *
+ * The sim target puts sim/include ahead of include/ on the quote search
+ * path, so src/autons.cpp picks this file up and compiles against the
+ * simulated devices instead of the PROS kernel.
+ */
+
+#include "sim_api.hpp"
+#include "organiz/scheduler.h"
+#include "organiz/drive_io.h"
+#include "organiz/odometry.h"
+#include "organiz/odom_math.h"
+#include "organiz/relocalize.h"
+#include "organiz/profiled_drive.h"
+#include "organiz/characterize.h"
+#include "organiz/autotune.h"
+#include "organiz/settle.h"
+#include "organiz/routine.h"
+#include "organiz/timeline.h"
+#include "organiz/mechanism.h"
+#include "organiz/color_sort.h"
+#include "organiz/config.h"
+#include "organiz/field_draw.h"
+#include "organiz/auton_registry.h"
+#include "organiz/path_drive.h"
+
+// Devices, mirroring src/organiz/robot_config.cpp
+extern ez::Drive chassis;
+extern pros::Motor intake;
+extern pros::Optical color_checker;
+extern ez::Piston backClamp;
+extern ez::Piston intakePiston;
+extern ez::Piston doinker;
+extern pros::Motor ladybrown;
+extern pros::Rotation ladyBrownSensor;
+extern ArmController lady_brown;
+
+// Mirroring include/organiz/field_view.h, a no-op without the brain screen
+void field_view_path_set(const PathPoint* points, size_t count);
+
+// Autons, mirroring include/autons.hpp
+void do_nothing();
+void blue_ring_rush();
+void blue_goal_rush();
+void red_ring_rush();
+void red_goal_rush();
+void skills_code();
+void drive_example();
+void turn_example();
+void drive_and_turn();
+void wait_until_change_speed();
+void swing_example();
+void combining_movements();
+void interfered_example();
+
+void default_constants();
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <functional>
+#include <random>
+#include <vector>
+
+// Host-side simulation core.  Everything here is plain C++ so the sim can
+// run on a laptop; the PROS/EZ stand-ins in sim_api.hpp are built on top.
+namespace sim {
+
+// Virtual clock.  Nothing in the host build reads wall time; pros::delay
+// advances this clock and steps every registered periodic callback.
+class Clock {
+ public:
+  using Callback = std::function<void()>;
+
+  uint32_t millis() const { return now_us / 1000; }
+  uint64_t micros() const { return now_us; }
+
+  // Registers a callback that fires every period_ms, like a pros::Task
+  // looping on delay_until.  Callbacks fire in registration order.
+  void every(uint32_t period_ms, Callback fn);
+
+  // Steps time forward 1 ms at a time, firing due callbacks.
+  void advance(uint32_t ms);
+
+  // Rewinds to t = 0 without dropping registered callbacks.
+  void reset();
+
+ private:
+  struct Periodic {
+    uint32_t period;
+    uint32_t next;
+    Callback fn;
+  };
+  uint64_t now_us = 0;
+  bool advancing = false;
+  std::vector<Periodic> periodic;
+};
+
+// Robot pose in EZ's convention: inches, theta in degrees, clockwise
+// positive, 0 deg facing +y.
+struct Pose {
+  double x = 0.0;
+  double y = 0.0;
+  double theta = 0.0;
+};
+
+// Constants for the differential-drive model.  Defaults match the 81U
+// drive: 3.25" wheels at 450 rpm.
+struct DriveParams {
+  double free_speed = 76.6;           // in/s at 12 V
+  double time_constant = 0.12;        // s, powered response
+  double hold_time_constant = 0.05;   // s, decay with zero command on HOLD
+  double coast_time_constant = 0.60;  // s, decay with zero command on COAST
+  double wheel_diameter = 3.25;       // in, for motor rpm
+  double track_width = 12.0;          // in, effective (includes scrub)
+  double stall_current = 2500.0;      // mA per motor
+  double encoder_noise = 0.0;         // in, std dev per sample
+  double encoder_scale = 1.0;         // in read per in traveled, wheel size error
+  double gyro_noise = 0.0;            // deg, std dev per sample
+  double gyro_drift = 0.0;            // deg/s
+  double friction = 0.0;              // of full command it takes to overcome friction
+};
+
+// First-order differential-drive model.  Each side follows its commanded
+// voltage with a time constant and the pose is integrated along the exact
+// arc every physics step.
+class DriveModel {
+ public:
+  DriveParams params;
+
+  // Command is -1..1 of battery voltage per side.
+  void command(double left, double right);
+  void hold_set(bool hold) { brake_hold = hold; }
+  void step(double dt);
+  void reset(Pose start = {});
+  void heading_set(double theta) { truth.theta = theta; }
+
+  // Ground truth.
+  Pose pose() const { return truth; }
+  double left_command() const { return ul; }
+  double right_command() const { return ur; }
+  double left_velocity() const { return vl; }
+  double right_velocity() const { return vr; }
+
+  // Sensor readings, as the brain would see them.
+  double left_position();
+  double right_position();
+  double heading();
+  double gyro_rate() const;
+  double left_current() const;
+  double right_current() const;
+  void seed(uint32_t s) { rng.seed(s); }
+
+ private:
+  Pose truth;
+  double ul = 0.0, ur = 0.0;
+  double vl = 0.0, vr = 0.0;
+  double pl = 0.0, pr = 0.0;
+  double drift = 0.0;
+  bool brake_hold = false;
+  std::mt19937 rng{81};
+  double noise(double stddev);
+};
+
+// A spinning mechanism motor (intake, lift).  Position is in degrees like
+// pros::Motor::get_position.
+struct MotorModel {
+  double free_rpm = 600.0;
+  double time_constant = 0.05;
+  double command = 0.0;  // -1..1
+  double rpm = 0.0;
+  double position = 0.0;
+  double gravity = 0.0;  // rpm/s pulling an arm down while it's level
+  double level = 0.0;    // position the arm is level at
+  void step(double dt);
+  void reset() { command = rpm = position = 0.0; }
+};
+
+// Rings riding up the intake's hooks. A ring's place on the hooks is how
+// far the intake motor has turned since it was picked up, in deg. A ring
+// flies off if the hooks slow to half speed while it's at the top, and is
+// scored if it gets past the top without that.
+struct IntakeRing {
+  int color;  // 1 red, 2 blue
+  double picked_up;
+  bool ejected = false;
+  bool scored = false;
+};
+struct IntakeModel {
+  const MotorModel* motor = nullptr;
+  double sensor_at = 150;    // deg, where the optical sensor starts seeing a ring
+  double sensor_span = 90;   // deg of hooks the sensor sees a ring over
+  double top = 850;          // deg, where a ring can be thrown
+  double throw_span = 80;    // deg past the top a ring can still be thrown
+  std::vector<IntakeRing> rings;
+  void step();
+  // The ring in front of the optical sensor at intake position, or nullptr
+  const IntakeRing* at_sensor(double position) const;
+};
+
+// A distance sensor's mount: in ahead, in right, deg from forward.
+struct Rangefinder {
+  double forward, right, angle;
+};
+
+// The simulated world: one clock, one drivetrain and any mechanism motors.
+struct World {
+  Clock clock;
+  DriveModel drive;
+  std::vector<MotorModel*> motors;
+  IntakeModel intake;  // hooked up to a Motor by the devices, for pros::Optical
+  std::vector<int> left_ports;  // from the Drive constructor, so MotorGroups know their side
+  std::map<int, Rangefinder> rangefinders;   // by port, for pros::Distance
+  std::vector<std::array<double, 4>> walls;  // x1, y1, x2, y2 the rangefinders see
+  std::vector<std::function<void()>> on_reset;
+};
+
+World& world();
+
+// Puts the world back at t = 0 with the robot at start.
+void reset(Pose start = {});
+
+}  // namespace sim
@@ -0,0 +1,534 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "sim.hpp"
+
+// Host stand-ins for the slice of the okapi, PROS and EZ-Template API that
+// our auton code uses.  Signatures follow the real headers so src/ files
+// compile unchanged; behaviour comes from the models in sim.hpp.
+
+///
+// okapi units
+///
+namespace okapi {
+struct QLength {
+  double in;
+  constexpr QLength operator-() const { return {-in}; }
+};
+struct QAngle {
+  double deg;
+  constexpr QAngle operator-() const { return {-deg}; }
+};
+struct QTime {
+  double ms;
+};
+
+constexpr QLength inch = {1};
+constexpr QAngle degree = {1};
+constexpr QLength operator*(double x, QLength l) { return {x * l.in}; }
+constexpr QAngle operator*(double x, QAngle a) { return {x * a.deg}; }
+
+namespace literals {
+constexpr QLength operator""_in(long double x) { return {static_cast<double>(x)}; }
+constexpr QLength operator""_in(unsigned long long x) { return {static_cast<double>(x)}; }
+constexpr QLength operator""_cm(long double x) { return {static_cast<double>(x) / 2.54}; }
+constexpr QLength operator""_cm(unsigned long long x) { return {static_cast<double>(x) / 2.54}; }
+constexpr QAngle operator""_deg(long double x) { return {static_cast<double>(x)}; }
+constexpr QAngle operator""_deg(unsigned long long x) { return {static_cast<double>(x)}; }
+constexpr QTime operator""_ms(long double x) { return {static_cast<double>(x)}; }
+constexpr QTime operator""_ms(unsigned long long x) { return {static_cast<double>(x)}; }
+constexpr QTime operator""_s(long double x) { return {static_cast<double>(x) * 1000.0}; }
+constexpr QTime operator""_s(unsigned long long x) { return {static_cast<double>(x) * 1000.0}; }
+}  // namespace literals
+}  // namespace okapi
+
+using namespace okapi::literals;
+
+///
+// PROS
+///
+namespace pros {
+enum motor_brake_mode_e_t { E_MOTOR_BRAKE_COAST = 0,
+                            E_MOTOR_BRAKE_BRAKE = 1,
+                            E_MOTOR_BRAKE_HOLD = 2 };
+
+void delay(std::uint32_t milliseconds);
+namespace competition {
+inline std::uint8_t is_disabled() { return false; }
+}  // namespace competition
+std::uint32_t millis();
+std::uint64_t micros();
+
+// Tasks don't exist on the host, PeriodicLoop runs on the sim clock instead
+// (sim/scheduler.cpp)
+class Task;
+
+// Only one thing runs at a time on the sim clock, so there's never a wait
+class Mutex {
+ public:
+  bool take(std::uint32_t = 0) { return true; }
+  bool give() { return true; }
+};
+
+enum task_state_e_t { E_TASK_STATE_RUNNING = 0, E_TASK_STATE_READY, E_TASK_STATE_BLOCKED };
+
+class Motor;
+
+// Drive sensors are read through ez::Drive and only take settings. A
+// mechanism's sensor reads the output of the Motor it's built with.
+class Rotation {
+ public:
+  Rotation() = default;
+  Rotation(std::int8_t port, Motor& joint);
+  std::int32_t set_data_rate(std::uint32_t) const { return 1; }
+  std::int32_t get_position() const;  // centidegrees
+  std::int32_t reset();
+
+ private:
+  const sim::MotorModel* joint = nullptr;
+  double zero = 0.0;
+};
+struct imu_raw_s {
+  double x, y, z, w;
+};
+typedef imu_raw_s imu_gyro_s_t;
+struct Imu {
+  std::int32_t set_data_rate(std::uint32_t) const { return 1; }
+  imu_gyro_s_t get_gyro_rate() const;
+};
+
+// Distance sensor seeing world().walls from world().rangefinders[port]. A new
+// reading every 33 ms of where the wall was 15 ms before, with the real
+// sensor's noise and one reading in 20 blocked short by another robot.
+class Distance {
+ public:
+  explicit Distance(std::int8_t port);
+  std::int32_t get();
+  std::int32_t get_confidence();
+
+ private:
+  int port;
+  std::uint32_t last_sample = 0;
+  std::int32_t value = 9999;
+  std::int32_t confidence = 0;
+};
+
+// Optical sensor watching world().intake's hooks. A new sample every
+// integration time, of where the hooks were halfway through it.
+class Optical {
+ public:
+  explicit Optical(std::uint8_t) {}
+  std::int32_t set_integration_time(double time);
+  std::int32_t set_led_pwm(std::uint8_t) { return 1; }
+  double get_hue();
+  double get_saturation();
+  std::int32_t get_proximity();
+
+ private:
+  void sample();
+  double integration = 100;  // ms, the real sensor's default
+  std::int64_t last_sample = -1;
+  double hue = 0;
+  double saturation = 0;
+  std::int32_t proximity = 0;
+};
+
+// GPS on the true pose with 0.5 in of noise, field origin at the sim's origin
+class Gps {
+ public:
+  explicit Gps(std::uint8_t) {}
+  std::int32_t set_data_rate(std::uint32_t) const { return 1; }
+  double get_position_x() const;
+  double get_position_y() const;
+  double get_error() const;
+};
+
+// Mechanism motor backed by sim::MotorModel
+class Motor {
+ public:
+  explicit Motor(std::int8_t port);
+  Motor(const Motor&) = delete;
+  Motor& operator=(const Motor&) = delete;
+  std::int32_t move(std::int32_t voltage);
+  std::int32_t move_voltage(std::int32_t voltage);
+  std::int32_t brake();
+  std::int32_t tare_position();
+  double get_position() const;
+  double get_actual_velocity() const;
+  std::int8_t get_port() const { return port; }
+  sim::MotorModel& sim_model() { return model; }
+
+ private:
+  std::int8_t port;
+  sim::MotorModel model;
+  double zero = 0.0;
+};
+
+// Drive motor group, one side of the simulated drive. The side comes from
+// whether its first port is one of the chassis' left ports.
+class MotorGroup {
+ public:
+  MotorGroup(std::initializer_list<std::int8_t> ports) : ports(ports) {}
+  MotorGroup(const std::vector<std::int8_t>& ports) : ports(ports) {}
+  std::int32_t move_voltage(std::int32_t voltage) const;
+  double get_actual_velocity(std::uint8_t index = 0) const;
+  std::int32_t get_current_draw(std::uint8_t index = 0) const;
+  std::int32_t get_voltage(std::uint8_t index = 0) const;
+  std::int8_t size() const { return ports.size(); }
+
+ private:
+  bool left() const;
+  std::vector<std::int8_t> ports;
+};
+}  // namespace pros
+
+#define TASK_PRIORITY_MAX 16
+#define TASK_PRIORITY_DEFAULT 8
+#define TASK_PRIORITY_MIN 1
+
+#define MOTOR_BRAKE_COAST pros::E_MOTOR_BRAKE_COAST
+#define MOTOR_BRAKE_BRAKE pros::E_MOTOR_BRAKE_BRAKE
+#define MOTOR_BRAKE_HOLD pros::E_MOTOR_BRAKE_HOLD
+
+///
+// EZ-Template
+///
+namespace ez {
+enum e_swing { LEFT_SWING = 0,
+               RIGHT_SWING = 1 };
+
+enum exit_output { RUNNING = 1,
+                   SMALL_EXIT = 2,
+                   BIG_EXIT = 3,
+                   VELOCITY_EXIT = 4,
+                   mA_EXIT = 5,
+                   ERROR_NO_CONSTANTS = 6 };
+
+enum e_mode { DISABLE = 0,
+              SWING = 1,
+              TURN = 2,
+              TURN_TO_POINT = 3,
+              DRIVE = 4,
+              POINT_TO_POINT = 5,
+              PURE_PURSUIT = 6 };
+
+const double ANGLE_NOT_SET = 0.0000000000000000000001;
+
+typedef struct pose {
+  double x;
+  double y;
+  double theta = ANGLE_NOT_SET;
+} pose;
+
+enum drive_directions { FWD = 0,
+                        fwd = FWD,
+                        REV = 1,
+                        rev = REV };
+
+enum e_angle_behavior { raw = 0,
+                        left_turn = 1,
+                        right_turn = 2,
+                        shortest = 3,
+                        longest = 4 };
+
+typedef struct odom {
+  pose target;
+  drive_directions drive_direction;
+  int max_xy_speed;
+  e_angle_behavior turn_behavior = shortest;
+} odom;
+
+std::string exit_to_string(exit_output input);
+
+namespace util {
+const int DELAY_TIME = 10;
+inline bool SD_CARD_ACTIVE = false;
+int sgn(double input);
+double clamp(double input, double max, double min);
+}  // namespace util
+
+// Same math as ez::PID: per-tick derivative on measurement, integral only
+// inside start_i and reset on sign change, timer based exit conditions
+class PID {
+ public:
+  struct Constants {
+    double kp;
+    double ki;
+    double kd;
+    double start_i;
+  };
+  struct exit_condition_ {
+    int small_exit_time = 0;
+    double small_error = 0;
+    int big_exit_time = 0;
+    double big_error = 0;
+    int velocity_exit_time = 0;
+    int mA_timeout = 0;
+  };
+
+  PID();
+  PID(double p, double i = 0, double d = 0, double start_i = 0, std::string name = "");
+  void constants_set(double p, double i = 0, double d = 0, double p_start_i = 0);
+  void exit_condition_set(int p_small_exit_time, double p_small_error, int p_big_exit_time = 0, double p_big_error = 0, int p_velocity_exit_time = 0, int p_mA_timeout = 0);
+  void target_set(double input);
+  double compute(double current);
+  double target_get();
+  Constants constants_get();
+  bool constants_set_check();
+  void variables_reset();
+  void timers_reset();
+
+  // The simulated motors report over-current through this flag
+  ez::exit_output exit_condition(bool over_current = false);
+
+  Constants constants = {0, 0, 0, 0};
+  exit_condition_ exit;
+
+  double output = 0.0;
+  double cur = 0.0;
+  double error = 0.0;
+  double target = 0.0;
+  double prev_error = 0.0;
+  double prev_current = 0.0;
+  double integral = 0.0;
+  double derivative = 0.0;
+
+ private:
+  double velocity_zero_main = 0.05;
+  int i = 0, j = 0, k = 0, l = 0;
+  std::string name;
+};
+
+class slew {
+ public:
+  struct Constants {
+    double min_speed = 0;
+    double distance_to_travel = 0;
+  };
+  Constants constants;
+
+  void constants_set(double distance, int minimum_speed);
+  void initialize(bool enabled, double maximum_speed, double target, double current);
+  double iterate(double current);
+  bool enabled() { return is_enabled; }
+  void speed_max_set(double speed) { max_speed = speed; }
+  double speed_max_get() { return max_speed; }
+
+ private:
+  int sign = 0;
+  double start = 0;
+  double max_speed = 0;
+  bool is_enabled = false;
+};
+
+class Piston {
+ public:
+  Piston(int input_port, bool default_state = false);
+  void set(bool input);
+  bool get();
+  void button_toggle(int toggle);
+  void buttons(int active, int deactive);
+
+ private:
+  int port;
+  bool current = false;
+  int last_press = 0;
+};
+
+// Drivetrain stand-in.  Runs the same drive / turn / swing loops as
+// ez::Drive on a 10 ms virtual task against sim::DriveModel.
+class Drive {
+ public:
+  Drive(std::vector<int> left_motor_ports, std::vector<int> right_motor_ports, int imu_port, double wheel_diameter, double ratio, int left_rotation_port, int right_rotation_port);
+
+  // One single-port group per drive motor, standing in for EZ's motor
+  // vectors. Every motor on a side shares that side's command.
+  std::vector<pros::MotorGroup> left_motors;
+  std::vector<pros::MotorGroup> right_motors;
+  pros::Imu imu;
+  pros::Rotation left_rotation;
+  pros::Rotation right_rotation;
+
+  // The 10 ms task is a sim clock event, so anything else only ever runs
+  // between its updates
+  struct {
+    std::uint32_t get_state() const { return pros::E_TASK_STATE_BLOCKED; }
+  } ez_auto;
+
+  PID headingPID;
+  PID turnPID;
+  PID leftPID;
+  PID rightPID;
+  PID forward_drivePID;
+  PID backward_drivePID;
+  PID swingPID;
+  PID xyPID;
+  PID forward_swingPID;
+  PID backward_swingPID;
+
+  ez::slew slew_left;
+  ez::slew slew_right;
+  ez::slew slew_forward;
+  ez::slew slew_backward;
+  ez::slew slew_turn;
+  ez::slew slew_swing;
+  ez::slew slew_swing_forward;
+  ez::slew slew_swing_backward;
+
+  e_mode mode = DISABLE;
+  e_swing current_swing = LEFT_SWING;
+  bool interfered = false;
+  int CURRENT_MA = 2500;
+
+  // Constants
+  void pid_heading_constants_set(double p, double i = 0.0, double d = 0.0, double p_start_i = 0.0);
+  void pid_drive_constants_set(double p, double i = 0.0, double d = 0.0, double p_start_i = 0.0);
+  void pid_drive_constants_forward_set(double p, double i = 0.0, double d = 0.0, double p_start_i = 0.0);
+  void pid_drive_constants_backward_set(double p, double i = 0.0, double d = 0.0, double p_start_i = 0.0);
+  void pid_turn_constants_set(double p, double i = 0.0, double d = 0.0, double p_start_i = 0.0);
+  void pid_swing_constants_set(double p, double i = 0.0, double d = 0.0, double p_start_i = 0.0);
+  void pid_swing_constants_forward_set(double p, double i = 0.0, double d = 0.0, double p_start_i = 0.0);
+  void pid_swing_constants_backward_set(double p, double i = 0.0, double d = 0.0, double p_start_i = 0.0);
+  PID::Constants pid_drive_constants_get() { return forward_drivePID.constants; }
+  PID::Constants pid_turn_constants_get() { return turnPID.constants; }
+  PID::Constants pid_swing_constants_get() { return swingPID.constants; }
+  PID::Constants pid_heading_constants_get() { return headingPID.constants; }
+
+  void pid_drive_exit_condition_set(int p_small_exit_time, double p_small_error, int p_big_exit_time, double p_big_error, int p_velocity_exit_time, int p_mA_timeout, bool use_imu = true);
+  void pid_turn_exit_condition_set(int p_small_exit_time, double p_small_error, int p_big_exit_time, double p_big_error, int p_velocity_exit_time, int p_mA_timeout, bool use_imu = true);
+  void pid_swing_exit_condition_set(int p_small_exit_time, double p_small_error, int p_big_exit_time, double p_big_error, int p_velocity_exit_time, int p_mA_timeout, bool use_imu = true);
+  void pid_drive_exit_condition_set(okapi::QTime p_small_exit_time, okapi::QLength p_small_error, okapi::QTime p_big_exit_time, okapi::QLength p_big_error, okapi::QTime p_velocity_exit_time, okapi::QTime p_mA_timeout, bool use_imu = true);
+  void pid_turn_exit_condition_set(okapi::QTime p_small_exit_time, okapi::QAngle p_small_error, okapi::QTime p_big_exit_time, okapi::QAngle p_big_error, okapi::QTime p_velocity_exit_time, okapi::QTime p_mA_timeout, bool use_imu = true);
+  void pid_swing_exit_condition_set(okapi::QTime p_small_exit_time, okapi::QAngle p_small_error, okapi::QTime p_big_exit_time, okapi::QAngle p_big_error, okapi::QTime p_velocity_exit_time, okapi::QTime p_mA_timeout, bool use_imu = true);
+
+  void slew_drive_constants_set(okapi::QLength distance, int min_speed);
+  void slew_turn_constants_set(okapi::QAngle distance, int min_speed);
+  void slew_swing_constants_set(okapi::QAngle distance, int min_speed);
+  void slew_drive_constants_forward_set(okapi::QLength distance, int min_speed);
+  void slew_drive_constants_backward_set(okapi::QLength distance, int min_speed);
+  void slew_swing_constants_forward_set(okapi::QAngle distance, int min_speed);
+  void slew_swing_constants_backward_set(okapi::QAngle distance, int min_speed);
+
+  // The sim's quick chain doesn't look at direction, so forward and backward
+  // share one constant
+  void pid_drive_chain_constant_set(double input) { drive_chain = input; }
+  void pid_drive_chain_constant_set(okapi::QLength input) { drive_chain = input.in; }
+  double pid_drive_chain_constant_get() { return drive_chain; }
+  void pid_drive_chain_forward_constant_set(double input) { drive_chain = input; }
+  void pid_drive_chain_backward_constant_set(double input) { drive_chain = input; }
+  double pid_drive_chain_forward_constant_get() { return drive_chain; }
+  double pid_drive_chain_backward_constant_get() { return drive_chain; }
+  void pid_turn_chain_constant_set(double input) { turn_chain = input; }
+  void pid_turn_chain_constant_set(okapi::QAngle input) { turn_chain = input.deg; }
+  double pid_turn_chain_constant_get() { return turn_chain; }
+  void pid_swing_chain_constant_set(double input) { swing_chain = input; }
+  void pid_swing_chain_constant_set(okapi::QAngle input) { swing_chain = input.deg; }
+  double pid_swing_chain_constant_get() { return swing_chain; }
+  void pid_swing_chain_forward_constant_set(double input) { swing_chain = input; }
+  void pid_swing_chain_backward_constant_set(double input) { swing_chain = input; }
+  double pid_swing_chain_forward_constant_get() { return swing_chain; }
+  double pid_swing_chain_backward_constant_get() { return swing_chain; }
+
+  void pid_speed_max_set(int speed);
+  int pid_speed_max_get() { return max_speed; }
+
+  // Motions
+  void pid_drive_set(double target, int speed, bool slew_on = false, bool toggle_heading = true);
+  void pid_drive_set(okapi::QLength p_target, int speed, bool slew_on = false, bool toggle_heading = true);
+  void pid_turn_set(double target, int speed, bool slew_on = false);
+  void pid_turn_set(okapi::QAngle p_target, int speed, bool slew_on = false);
+  void pid_swing_set(e_swing type, double target, int speed, int opposite_speed = 0, bool slew_on = false);
+  void pid_swing_set(e_swing type, double target, int speed, bool slew_on);
+  void pid_swing_set(e_swing type, okapi::QAngle p_target, int speed, int opposite_speed = 0, bool slew_on = false);
+  void pid_swing_set(e_swing type, okapi::QAngle p_target, int speed, bool slew_on);
+  void pid_targets_reset();
+
+  // Pure pursuit, simplified: heads for the first point past the look ahead
+  // with headingPID and runs the drive constants on what's left of the path.
+  // The last point's angle, turn behavior and slew are ignored. Injected
+  // paths start from the robot like EZ's, without injecting points between.
+  void pid_odom_pp_set(std::vector<ez::odom> imovements, bool slew_on = false);
+  void pid_odom_injected_pp_set(std::vector<ez::odom> imovements, bool slew_on = false);
+
+  void pid_wait();
+  void pid_wait_until(double target);
+  void pid_wait_until(okapi::QLength target) { pid_wait_until(target.in); }
+  void pid_wait_until(okapi::QAngle target) { pid_wait_until(target.deg); }
+  void pid_wait_quick();
+  void pid_wait_quick_chain();
+
+  // Drive and sensors
+  void drive_set(int left, int right);
+  std::vector<int> drive_get() { return {last_left, last_right}; }
+  void drive_mode_set(e_mode p_mode, bool stop_drive = true);
+  e_mode drive_mode_get() { return mode; }
+  void drive_brake_set(pros::motor_brake_mode_e_t brake_type);
+  pros::motor_brake_mode_e_t drive_brake_get() { return brake; }
+  void drive_angle_set(double angle);
+  void drive_angle_set(okapi::QAngle p_angle) { drive_angle_set(p_angle.deg); }
+  void drive_sensor_reset();
+  void drive_imu_reset(double new_heading = 0);
+  double drive_sensor_left();
+  double drive_sensor_right();
+  int drive_velocity_left();
+  int drive_velocity_right();
+  double drive_mA_left();
+  double drive_mA_right();
+  bool drive_current_left_over();
+  bool drive_current_right_over();
+  double drive_imu_get();
+  void drive_width_set(double input) { width = input; }
+  void drive_width_set(okapi::QLength p_input) { width = p_input.in; }
+  double drive_width_get() { return width; }
+
+  // Odometry (integrated from the simulated sensors, not ground truth)
+  pose odom_pose_get() { return odom; }
+  void odom_xyt_set(double x, double y, double t);
+  void odom_xy_set(double x, double y);
+  void odom_theta_set(double a);
+
+  // No brain screen, so the tuner never opens
+  void pid_tuner_enable() {}
+  void pid_tuner_disable() {}
+  bool pid_tuner_enabled() { return false; }
+
+  // Host only: puts the controller back to its power-on state
+  void sim_reset();
+
+ private:
+  void ez_auto_task();
+  void drive_pid_task();
+  void turn_pid_task();
+  void swing_pid_task();
+  void pp_task();
+  void odom_update();
+  ez::exit_output wait_exit();
+
+  double wheel_diameter;
+  double ratio;
+  double width = 0.0;  // EZ's default too, default_constants() sets it
+  int max_speed = 0;
+  int swing_opposite_speed = 0;
+  bool heading_on = true;
+  int last_left = 0, last_right = 0;
+  pros::motor_brake_mode_e_t brake = pros::E_MOTOR_BRAKE_COAST;
+  double l_start = 0, r_start = 0;
+  double motion_target = 0;
+  double l_zero = 0, r_zero = 0, imu_zero = 0;
+  double drive_chain = 3.0, turn_chain = 3.0, swing_chain = 5.0;
+  std::vector<ez::odom> pp_path;
+  std::vector<double> pp_left;  // path length from each point to the end
+  size_t pp_index = 0;
+  double look_ahead = 7.0;  // EZ's default, in
+  pose odom = {0, 0, 0};
+  double odom_l = 0, odom_r = 0, odom_t = 0;
+};
+}  // namespace ez
+
+using namespace ez;
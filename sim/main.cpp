@@ -0,0 +1,1010 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "main.h"
+
+// Host runner: plays autons on the simulated drive and reports how long
+// they took in robot time and where the robot ended up.
+//
+//   make sim && ./bin/sim [--runs N] [name filter]
+//   ./bin/sim --list     the auton registry
+//   ./bin/sim --mirror   checks each red auton ends as the x-mirror of its blue one
+//   ./bin/sim --chain    time saved by chain() on the autons as serial step routines
+//   ./bin/sim --timeline the autons as serial step routines against their timelines
+//   ./bin/sim --profile  profiled straight drives against pid_drive_set
+//   ./bin/sim --width    profiled turns and the fused odom heading with and without a track width
+//   ./bin/sim --path     a path through pid_path_set() on its first run, from the cache, after path_prepare() and raw_first
+//   ./bin/sim --pack F   writes every drive profile the autons use to trajectory pack F
+//   ./bin/sim --odom     pose error seen by a 1 ms consumer, latest update vs extrapolated
+//   ./bin/sim --drift    odometry integrators and heading sources against ground truth
+//   ./bin/sim --ekf      odometry against the EKF with GPS and distance sensor corrections
+//   ./bin/sim --reloc    relocalization against the walls with simulated distance sensors
+//   ./bin/sim --arm      lady brown cycle, the old P loop against ArmController
+//   ./bin/sim --sort     color sort at several intake speeds, fixed delay against encoder tracking
+//   ./bin/sim --characterize [F]  fits drive feedforward on a drive with static friction, optionally logging to F
+//   ./bin/sim --autotune relay autotunes the turn, drive and swing PIDs from default_constants()
+//   ./bin/sim --settle   auton time with EZ's exit timers against predicted settling
+//   ./bin/sim --field    screen pixels the brain field view redraws each frame, against redrawing the field
+//   ./bin/sim --config F saves default_constants() to config store F, then loads it back over other constants
+//   ./bin/sim --characterized [mode]  counts the hand-set drive feedforward as characterized, so profiled steps play
+
+// The hand-set feedforward was fitted to the sim's drive model, so here it
+// can stand in for a characterization run
+static bool characterized = false;
+
+// Mirrors autonomous() in src/main.cpp
+static uint32_t run_auton(const AutonInfo& a) {
+  sim::reset();
+  default_constants();
+  if (characterized) {
+    DriveProfileConstants c = drive_profile_constants_get();
+    drive_profile_feedforward_set(c.left, c.right);
+  }
+  chassis.pid_targets_reset();
+  chassis.drive_imu_reset();
+  chassis.drive_sensor_reset();
+  chassis.drive_brake_set(MOTOR_BRAKE_HOLD);
+  odom_start();
+  odom_reset(0, 0);
+  settle_stats_reset();
+
+  uint32_t start = pros::millis();
+  a.fn();
+  return pros::millis() - start;
+}
+
+// Blue/red pairs from the registry, the red side is mirror() of the blue steps
+static std::vector<std::array<AutonInfo, 2>> mirrored_pairs() {
+  std::vector<std::array<AutonInfo, 2>> pairs;
+  for (size_t i = 0; i < auton_registry.size(); i++) {
+    if (auton_registry[i].alliance == Alliance::BLUE) pairs.push_back({auton_registry[i], auton_registry[auton_mirror(i)]});
+  }
+  return pairs;
+}
+static const std::vector<std::array<AutonInfo, 2>> mirrored = mirrored_pairs();
+
+// The blue autons as serial step routines, before they were timelines.
+// Speeds are autons.cpp's DRIVE_SPEED, TURN_SPEED and SWING_SPEED.
+constexpr auto serial_ring_rush_steps = chain(std::array{
+  step_angle(90),
+  step_color_sort(RingColor::RED),
+  step_clamp(false),
+  step_drive_profiled(-10, 110),
+  step_swing(StepSide::LEFT, 0, 90),
+
+  step_intake(120),
+  step_delay(1000),
+  step_intake_stop(),
+
+  step_drive_profiled(10, 110),
+  step_swing(StepSide::LEFT, 45, 90),
+  step_drive_profiled(18, 110),
+  step_turn(-135, 90),
+  step_drive_profiled(-15, 110),
+
+  step_clamp(true),
+  step_delay(200),
+
+  step_turn(-260, 90),
+  step_intake(100),
+  step_drive_profiled(28, 110),
+  step_turn(-362, 90),
+  step_intake(120),
+  step_drive_profiled(24, 110),
+
+  no_wait(step_drive(0, 0)),
+  step_delay(500),
+
+  step_drive_profiled(-5, 110),
+  step_turn(-431, 90),
+  step_drive_profiled(40, 110),
+  step_intake_stop(),
+});
+constexpr auto serial_goal_rush_steps = chain(std::array{
+  step_angle(-30),
+  step_color_sort(RingColor::RED),
+  step_doinker(true),
+  step_drive_profiled(190, 110, true),
+  step_turn(-10, 90),
+  step_doinker(false),
+  step_drive_profiled(-10, 110, true),
+
+  no_wait(step_turn(-180, 90)),
+  step_doinker(true),
+  step_wait(),
+
+  no_wait(step_turn(-90, 90)),
+  step_doinker(false),
+  step_wait(),
+
+  step_drive_profiled(-10, 110),
+  step_clamp(true),
+  step_intake(100),
+  step_drive(0, 0),
+  step_delay(2000),
+  step_intake_stop(),
+});
+static const AutonInfo serial[][2] = {
+    {{"BLUE RING SIDE CODE", [] { routine_run(serial_ring_rush_steps); }}, {"BLUE RING SIDE CODE", blue_ring_rush}},
+    {{"BLUE GOAL SIDE CODE", [] { routine_run(serial_goal_rush_steps); }}, {"BLUE GOAL SIDE CODE", blue_goal_rush}},
+};
+
+static int check_mirror() {
+  int failed = 0;
+  for (const auto& pair : mirrored) {
+    uint32_t blue_ms = run_auton(pair[0]);
+    sim::Pose blue = sim::world().drive.pose();
+    uint32_t red_ms = run_auton(pair[1]);
+    sim::Pose red = sim::world().drive.pose();
+
+    double err = std::max({std::abs(blue.x + red.x), std::abs(blue.y - red.y), std::abs(blue.theta + red.theta)});
+    bool ok = err < 1e-6 && blue_ms == red_ms;
+    printf("%-20s / %-20s %6u / %6u ms  max error %.2g  %s\n", pair[0].name, pair[1].name, blue_ms, red_ms, err, ok ? "ok" : "MISMATCH");
+    if (!ok) failed++;
+  }
+  return failed == 0 ? 0 : 1;
+}
+
+static int report_chaining() {
+  printf("%-20s %9s %9s %8s %10s\n", "auton", "settle_ms", "chain_ms", "saved", "end_moved");
+  uint32_t total_settle = 0, total_chain = 0;
+  for (const auto& pair : serial) {
+    const AutonInfo& a = pair[0];
+    routine_chaining_set(false);
+    uint32_t settle_ms = run_auton(a);
+    sim::Pose settle = sim::world().drive.pose();
+    routine_chaining_set(true);
+    uint32_t chain_ms = run_auton(a);
+    sim::Pose chained = sim::world().drive.pose();
+
+    total_settle += settle_ms;
+    total_chain += chain_ms;
+    printf("%-20s %9u %9u %7.1f%% %8.2fin\n", a.name, settle_ms, chain_ms, 100.0 * ((double)settle_ms - chain_ms) / settle_ms,
+           std::hypot(chained.x - settle.x, chained.y - settle.y));
+  }
+  printf("%-20s %9u %9u %7.1f%%\n", "total", total_settle, total_chain, 100.0 * ((double)total_settle - total_chain) / total_settle);
+  return 0;
+}
+
+static int report_timeline() {
+  printf("%-20s %9s %9s %8s %10s\n", "auton", "serial_ms", "timeline_ms", "saved", "end_moved");
+  for (const auto& pair : serial) {
+    uint32_t serial_ms = run_auton(pair[0]);
+    sim::Pose before = sim::world().drive.pose();
+    uint32_t timeline_ms = run_auton(pair[1]);
+    sim::Pose after = sim::world().drive.pose();
+    printf("%-20s %9u %11u %7.1f%% %8.2fin\n", pair[0].name, serial_ms, timeline_ms,
+           100.0 * ((double)serial_ms - timeline_ms) / serial_ms, std::hypot(after.x - before.x, after.y - before.y));
+  }
+  return 0;
+}
+
+// One straight drive from rest, returns ms until pid_wait() let go
+static uint32_t straight_drive(double distance, bool profiled, double& error) {
+  run_auton({"", [] {}});
+  uint32_t start = pros::millis();
+  if (profiled)
+    drive_profiled(distance, 110);
+  else
+    chassis.pid_drive_set(distance, 110, std::fabs(distance) > 12);
+  chassis.pid_wait();
+  error = distance - sim::world().drive.pose().y;
+  return pros::millis() - start;
+}
+
+static int report_profiles() {
+  printf("%8s %9s %9s %8s %10s %10s\n", "in", "pid_ms", "prof_ms", "saved", "pid_err", "prof_err");
+  for (double d : {-15.0, -10.0, 10.0, 18.0, 24.0, 28.0, 40.0, 72.0, 190.0}) {
+    double pid_err, prof_err;
+    uint32_t pid_ms = straight_drive(d, false, pid_err);
+    uint32_t prof_ms = straight_drive(d, true, prof_err);
+    printf("%8.0f %9u %9u %7.1f%% %9.2fin %9.2fin\n", d, pid_ms, prof_ms, 100.0 * ((double)pid_ms - prof_ms) / pid_ms, pid_err, prof_err);
+  }
+  return 0;
+}
+
+// Profiled turns and the fused odom heading with no track width, as EZ
+// starts, against the one default_constants() sets
+static int report_width() {
+  printf("%-8s %10s %10s %10s %s\n", "width", "turn_err", "swing_err", "odom_t", "fused");
+  bool ok = true;
+  for (bool set : {false, true}) {
+    run_auton({"", [] {}});
+    if (!set) chassis.drive_width_set(0.0);
+    bool fused = odom_heading_set(OdomHeading::FUSED);
+
+    turn_profiled(90, 90);
+    chassis.pid_wait();
+    double turn_err = 90 - sim::world().drive.pose().theta;
+    swing_profiled(ez::LEFT_SWING, 135, 90);
+    chassis.pid_wait();
+    double swing_err = 135 - sim::world().drive.pose().theta;
+    double odom_t = odom_state().theta;
+    odom_heading_set(OdomHeading::IMU);
+
+    printf("%6.2fin %7.2fdeg %7.2fdeg %7.2fdeg %s\n", chassis.drive_width_get(), turn_err, swing_err, odom_t,
+           fused ? "yes" : "refused");
+    ok = ok && fused == set && std::isfinite(odom_t) && std::fabs(turn_err) < 3 && std::fabs(swing_err) < 3;
+  }
+  return ok ? 0 : 1;
+}
+
+// A path through pid_path_set() on its first run after boot, again from the
+// cache, and mirrored after a path_prepare() the loop hasn't finished. The
+// first two have to end the same, the first run doesn't get a rougher path.
+// Then a third path raw_first twice, straight the first time and smoothed by
+// the loop the second.
+static int report_path() {
+  const std::vector<ez::odom> path = {
+      {{0, 0}, fwd, 110}, {{0, 24}, fwd, 110}, {{24, 48}, fwd, 110}, {{24, 72}, fwd, 110}};
+  std::vector<ez::odom> mirrored_path = path;
+  for (ez::odom& w : mirrored_path) w.target.x = -w.target.x;
+  std::vector<ez::odom> narrow_path = path;
+  for (ez::odom& w : narrow_path) w.target.x /= 2;
+
+  printf("%-10s %8s %8s %8s %8s %5s %7s %8s %6s %4s\n", "run", "time_ms", "x", "y", "theta", "hits", "misses", "smoothed",
+         "waits", "raw");
+  sim::Pose ends[5];
+  bool ok = true;
+  const char* names[] = {"first", "cached", "prepared", "raw first", "raw again"};
+  for (int run = 0; run < 5; run++) {
+    run_auton({"", [] {}});
+    const std::vector<ez::odom>& p = run == 2 ? mirrored_path : run >= 3 ? narrow_path : path;
+    if (run == 2) path_prepare(p.data(), p.size());
+
+    uint32_t start = pros::millis();
+    pid_path_set(p.data(), p.size(), false, run >= 3);
+    chassis.pid_wait();
+    uint32_t ms = pros::millis() - start;
+
+    ends[run] = sim::world().drive.pose();
+    PathStats stats = path_stats();
+    printf("%-10s %8u %8.2f %8.2f %8.2f %5u %7u %8u %6u %4u\n", names[run], ms, ends[run].x, ends[run].y,
+           ends[run].theta, stats.hits, stats.misses, stats.smoothed_now, stats.waits, stats.raw_starts);
+    const ez::pose& end = p.back().target;
+    // Within the drive's big error. The last 2 in are a crawl here, as for
+    // pid_drive_set(), until the velocity exit.
+    ok = ok && std::hypot(ends[run].x - end.x, ends[run].y - end.y) < 3;
+  }
+  PathStats stats = path_stats();
+  ok = ok && ends[0].x == ends[1].x && ends[0].y == ends[1].y && ends[0].theta == ends[1].theta;
+  ok = ok && stats.hits == 3 && stats.misses == 3 && stats.smoothed_now == 1 && stats.waits == 1 &&
+       stats.raw_starts == 1 && stats.fallbacks == 0;
+
+  // One waypoint is where the robot already is, nothing for EZ
+  run_auton({"", [] {}});
+  pid_path_set(path.data(), 1);
+  ok = ok && chassis.drive_mode_get() == ez::DISABLE && path_stats().fallbacks == 0;
+  return ok ? 0 : 1;
+}
+
+static int write_pack(const char* path) {
+  characterized = true; // otherwise no step plays a profile
+  std::vector<uint32_t> planned_ms;
+  for (const auto& pair : mirrored)
+    for (const AutonInfo& a : pair) planned_ms.push_back(run_auton(a));
+
+  if (!profile_pack_write(path)) {
+    perror(path);
+    return 1;
+  }
+  int count = profile_pack_load(path);
+  printf("%s: %d profiles\n", path, count);
+
+  // Running from the pack has to be indistinguishable from planning
+  size_t i = 0;
+  for (const auto& pair : mirrored) {
+    for (const AutonInfo& a : pair) {
+      if (run_auton(a) != planned_ms[i++]) {
+        printf("%s: different result from the pack\n", a.name);
+        return 1;
+      }
+    }
+  }
+  return count > 0 ? 0 : 1;
+}
+
+static int report_odom() {
+  // A 1 ms consumer, like a controller running on its own clock
+  static double latest_sum, extrap_sum;
+  static int samples;
+  sim::world().clock.every(1, [] {
+    OdomState s = odom_state();
+    ez::pose now = odom_pose_at(pros::micros());
+    sim::Pose truth = sim::world().drive.pose();
+    latest_sum += std::hypot(s.x - truth.x, s.y - truth.y);
+    extrap_sum += std::hypot(now.x - truth.x, now.y - truth.y);
+    samples++;
+  });
+
+  printf("%-20s %12s %12s\n", "auton", "latest_err", "extrap_err");
+  for (const auto& pair : mirrored) {
+    latest_sum = extrap_sum = 0;
+    samples = 0;
+    run_auton(pair[0]);
+    printf("%-20s %10.3fin %10.3fin\n", pair[0].name, latest_sum / samples, extrap_sum / samples);
+  }
+  return 0;
+}
+
+struct DriftEstimator {
+  const char* name;
+  OdomIntegrator integrator;
+  OdomHeading heading;
+  uint32_t period;
+  double x = 0, y = 0, theta = 0;
+  double prev_l = 0, prev_r = 0, prev_imu = 0;
+  double max_err = 0;
+  HeadingFilter filter;
+};
+
+static DriftEstimator drift_est[] = {
+    {"euler / imu", OdomIntegrator::EULER, OdomHeading::IMU, 10},
+    {"midpoint / imu", OdomIntegrator::MIDPOINT, OdomHeading::IMU, 10},
+    {"arc / imu", OdomIntegrator::ARC, OdomHeading::IMU, 10},
+    {"arc / wheels", OdomIntegrator::ARC, OdomHeading::WHEELS, 10},
+    {"arc / fused", OdomIntegrator::ARC, OdomHeading::FUSED, 10},
+    {"euler / imu", OdomIntegrator::EULER, OdomHeading::IMU, 5},
+    {"arc / fused", OdomIntegrator::ARC, OdomHeading::FUSED, 5},
+};
+static double drift_width;  // track width the estimators believe
+
+static void drift_update(DriftEstimator& e) {
+  sim::DriveModel& drive = sim::world().drive;
+  double l = drive.left_position(), r = drive.right_position(), imu = drive.heading();
+  double dl = l - e.prev_l, dr = r - e.prev_r;
+  double wheel_delta = (dl - dr) / drift_width;
+  double gyro_delta = drive.gyro_rate() * e.period / 1000.0 * M_PI / 180;
+
+  double d_theta = e.heading == OdomHeading::IMU      ? (imu - e.prev_imu) * M_PI / 180
+                   : e.heading == OdomHeading::WHEELS ? wheel_delta
+                                                        : e.filter.update(gyro_delta, wheel_delta, imu * M_PI / 180) - e.theta * M_PI / 180;
+  OdomStep step = odom_step(e.integrator, (dl + dr) / 2, d_theta);
+  double dir = e.theta * M_PI / 180 + step.angle;
+  e.x += step.length * std::sin(dir);
+  e.y += step.length * std::cos(dir);
+  e.theta += d_theta * 180 / M_PI;
+  e.prev_l = l;
+  e.prev_r = r;
+  e.prev_imu = imu;
+
+  sim::Pose truth = drive.pose();
+  e.max_err = std::max(e.max_err, std::hypot(e.x - truth.x, e.y - truth.y));
+}
+
+// A minute of skills-speed driving (sweeping arcs, straights and spins)
+// with every estimator running on its own period
+static void drift_run(const char* title) {
+  sim::reset();
+  for (DriftEstimator& e : drift_est) {
+    e.x = e.y = e.theta = e.prev_l = e.prev_r = e.prev_imu = e.max_err = 0;
+    e.filter.theta = 0;
+  }
+
+  sim::DriveModel& drive = sim::world().drive;
+  for (uint32_t t = 0; t < 60000; t += 10) {
+    double s = t / 1000.0;
+    double fwd = 0.85 * std::cos(s * 0.25);
+    double turn = 0.35 * std::sin(s * 0.9) + (std::fmod(s, 12) > 10.5 ? 0.6 : 0);
+    drive.command(fwd + turn, fwd - turn);
+    pros::delay(10);
+  }
+
+  sim::Pose truth = drive.pose();
+  printf("%s, 60 s, truth ended at (%.1f, %.1f, %.1f deg)\n", title, truth.x, truth.y, truth.theta);
+  printf("%-16s %6s %10s %10s %10s\n", "integrator", "period", "end_err", "max_err", "theta_err");
+  for (const DriftEstimator& e : drift_est) {
+    printf("%-16s %4ums %8.2fin %8.2fin %8.2fdeg\n", e.name, e.period, std::hypot(e.x - truth.x, e.y - truth.y), e.max_err,
+           e.theta - truth.theta);
+  }
+}
+
+static int report_drift() {
+  for (DriftEstimator& e : drift_est) sim::world().clock.every(e.period, [&e] { drift_update(e); });
+
+  sim::DriveModel& drive = sim::world().drive;
+  sim::DriveParams saved = drive.params;
+
+  // Integration error on its own
+  drift_width = drive.params.track_width;
+  drift_run("ideal sensors");
+
+  // Sensor noise, IMU drift of about 1 deg a minute, and wheels that scrub
+  // so the effective track width is wider than the measured one
+  drive.params.encoder_noise = 0.002;
+  drive.params.gyro_noise = 0.05;
+  drive.params.gyro_drift = 0.015;
+  drift_width = 11.6;
+  printf("\n");
+  drift_run("noisy sensors");
+
+  drive.params = saved;
+  return 0;
+}
+
+// Field walls, a 12 ft square around the sim's origin
+static const FieldSegment ekf_walls[] = {
+    {-72, -72, 72, -72}, {72, -72, 72, 72}, {72, 72, -72, 72}, {-72, 72, -72, -72}};
+// Distance sensors looking left and forward
+static const RangeMount ekf_ranges[] = {{0, -6, -90}, {7, 0, 0}};
+
+// Synthetic distance sensors every 50 ms, with 1 in 20 readings blocked
+// short by another robot
+static void ekf_range_corrector(PoseEkf& ekf, const DriveSnapshot& snap) {
+  static std::mt19937 rng{12};
+  static uint32_t last = 0;
+  if (snap.time - last < 50) return;
+  last = snap.time;
+
+  sim::Pose truth = sim::world().drive.pose();
+  for (const RangeMount& mount : ekf_ranges) {
+    double reading = field_ray_cast(truth.x, truth.y, truth.theta, mount, ekf_walls, 4);
+    if (reading < 0 || reading > 78) continue;  // out of range
+    reading += std::normal_distribution<double>(0, std::max(0.6, 0.05 * reading) / 2)(rng);
+    if (rng() % 20 == 0) reading *= 0.4;
+    ekf.update_range(mount, reading, ekf_walls, 4);
+  }
+}
+
+// Laps of a 8 ft square, steering on the true pose
+static void ekf_laps(uint32_t ms) {
+  static const double corners[][2] = {{48, 48}, {48, -48}, {-48, -48}, {-48, 48}};
+  sim::DriveModel& drive = sim::world().drive;
+  int next = 0;
+  for (uint32_t t = 0; t < ms; t += 10) {
+    sim::Pose p = drive.pose();
+    double dx = corners[next][0] - p.x, dy = corners[next][1] - p.y;
+    if (std::hypot(dx, dy) < 12) next = (next + 1) % 4;
+    double err = std::remainder(std::atan2(dx, dy) * 180 / M_PI - p.theta, 360.0);
+    double turn = std::clamp(err / 45, -1.0, 1.0);
+    double fwd = 0.8 * std::max(0.0, std::cos(err * M_PI / 180));
+    drive.command(fwd + turn * 0.5, fwd - turn * 0.5);
+    pros::delay(10);
+  }
+}
+
+static int report_ekf() {
+  static pros::Gps gps(1);
+  static double odom_max, odom_sum, ez_max;
+  static int samples;
+  sim::world().clock.every(10, [] {
+    sim::Pose truth = sim::world().drive.pose();
+    OdomState s = odom_state();
+    ez::pose ez_pose = chassis.odom_pose_get();
+    double err = std::hypot(s.x - truth.x, s.y - truth.y);
+    odom_max = std::max(odom_max, err);
+    odom_sum += err;
+    ez_max = std::max(ez_max, std::hypot(ez_pose.x - truth.x, ez_pose.y - truth.y));
+    samples++;
+  });
+
+  sim::DriveModel& drive = sim::world().drive;
+  sim::DriveParams saved = drive.params;
+  drive.params.encoder_noise = 0.002;
+  drive.params.gyro_noise = 0.05;
+  drive.params.gyro_drift = 0.015;
+  drive.params.encoder_scale = 1.015;
+  odom_start();
+
+  struct Config {
+    const char* name;
+    bool ekf;
+    pros::Gps* gps;
+    OdomCorrector corrector;
+  };
+  const Config configs[] = {
+      {"odometry", false, nullptr, nullptr},
+      {"ekf, wheels + imu", true, nullptr, nullptr},
+      {"ekf + gps", true, &gps, nullptr},
+      {"ekf + distance", true, nullptr, ekf_range_corrector},
+      {"ekf + gps + distance", true, &gps, ekf_range_corrector},
+  };
+
+  printf("noisy sensors, wheels reading 1.5%% long, 90 s of laps\n");
+  printf("%-22s %10s %10s %10s\n", "estimator", "mean_err", "max_err", "ez_max");
+  for (const Config& c : configs) {
+    sim::reset();
+    chassis.odom_xyt_set(0, 0, 0);
+    odom_ekf_enable(c.ekf);
+    odom_gps_set(c.gps, 0, 0);
+    odom_corrector_set(c.corrector);
+    odom_reset(0, 0);
+    pros::delay(10);
+    odom_max = odom_sum = ez_max = 0;
+    samples = 0;
+    ekf_laps(90000);
+    printf("%-22s %8.2fin %8.2fin %8.2fin\n", c.name, odom_sum / samples, odom_max, ez_max);
+  }
+
+  odom_ekf_enable(false);
+  odom_gps_set(nullptr, 0, 0);
+  odom_corrector_set(nullptr);
+  drive.params = saved;
+  return 0;
+}
+
+static int report_reloc() {
+  static double err_max, err_sum;
+  static int samples;
+  sim::world().clock.every(10, [] {
+    sim::Pose truth = sim::world().drive.pose();
+    ez::pose p = chassis.odom_pose_get();
+    double err = std::hypot(p.x - truth.x, p.y - truth.y);
+    err_max = std::max(err_max, err);
+    err_sum += err;
+    samples++;
+  });
+
+  // Left and front sensors, a 140.4 in field with the robot starting in the middle
+  sim::world().rangefinders[1] = {0, -6, -90};
+  sim::world().rangefinders[2] = {7, 0, 0};
+  sim::world().walls = {{-70.2, -70.2, 70.2, -70.2}, {70.2, -70.2, 70.2, 70.2}, {70.2, 70.2, -70.2, 70.2}, {-70.2, 70.2, -70.2, -70.2}};
+  reloc_map_clear();
+  reloc_map_walls(0, 0);
+  reloc_sensor_add(1, {0, -6, -90});
+  reloc_sensor_add(2, {7, 0, 0});
+
+  sim::DriveModel& drive = sim::world().drive;
+  sim::DriveParams saved = drive.params;
+  drive.params.encoder_noise = 0.002;
+  drive.params.gyro_noise = 0.05;
+  drive.params.gyro_drift = 0.05;
+  drive.params.encoder_scale = 1.03;
+  odom_start();
+
+  struct Config {
+    const char* name;
+    bool reloc;
+    uint32_t latency;
+  };
+  const Config configs[] = {
+      {"ez odometry", false, 0},
+      {"walls, not aligned", true, 0},
+      {"walls, time aligned", true, RELOC_LATENCY},
+  };
+
+  printf("noisy sensors, wheels reading 3%% long, IMU drifting 3 deg/min, 90 s of laps, chassis.odom_pose_get()\n");
+  printf("%-22s %10s %10s %6s %9s\n", "", "mean_err", "max_err", "used", "rejected");
+  for (const Config& c : configs) {
+    sim::reset();
+    chassis.odom_xyt_set(0, 0, 0);
+    odom_reset(0, 0);
+    reloc_latency_set(c.latency);
+    reloc_enable(c.reloc);
+    pros::delay(10);
+    err_max = err_sum = 0;
+    samples = 0;
+    ekf_laps(90000);
+    RelocStats stats = reloc_stats();
+    printf("%-22s %8.2fin %8.2fin %6d %9d\n", c.name, err_sum / samples, err_max, c.reloc ? stats.used : 0,
+           c.reloc ? stats.rejected : 0);
+    reloc_enable(false);
+  }
+
+  odom_ekf_enable(false);
+  odom_corrector_set(nullptr);
+  drive.params = saved;
+  return 0;
+}
+
+static int report_characterize(const char* log_path) {
+  sim::DriveModel& drive = sim::world().drive;
+  sim::DriveParams saved = drive.params;
+  drive.params.friction = 0.06;
+  drive.params.encoder_noise = 0.002;
+
+  run_auton({"", [] {}});
+  chassis.pid_turn_set(0, 90); // holding its heading, which the run has to hand back
+  DriveCharacterization fit = drive_characterize_run(log_path);
+  bool restored = chassis.drive_mode_get() == ez::TURN && chassis.drive_brake_get() == MOTOR_BRAKE_HOLD;
+  printf("drive mode and brake %s\n", restored ? "restored" : "NOT RESTORED");
+  const sim::DriveParams& p = drive.params;
+  Feedforward truth = {127 * p.friction, 127 / p.free_speed, 127 * p.time_constant / p.free_speed};
+  printf("%-8s %8s %8s %8s %8s %8s\n", "", "kS", "kV", "kA", "r2", "samples");
+  printf("%-8s %8.3f %8.4f %8.4f\n", "model", truth.kS, truth.kV, truth.kA);
+  for (const FeedforwardFit* side : {&fit.left, &fit.right}) {
+    printf("%-8s %8.3f %8.4f %8.4f %8.4f %8d\n", side == &fit.left ? "left" : "right", side->ff.kS, side->ff.kV,
+           side->ff.kA, side->r2, side->samples);
+  }
+
+  // The same motions on the hand-set gains from default_constants() and on the fit
+  // How far off the target the profile leaves the robot for the PID to finish
+  struct Motion {
+    const char* name;
+    void (*fn)();
+    double target;
+    bool angular;
+  };
+  const Motion motions[] = {
+      {"drive 24", [] { drive_profiled(24, 110); }, 24, false},
+      {"drive -40", [] { drive_profiled(-40, 110); }, -40, false},
+      {"turn 90", [] { turn_profiled(90, 90); }, 90, true},
+      {"swing 45", [] { swing_profiled(ez::LEFT_SWING, 45, 90); }, 45, true},
+  };
+  printf("\nleft to the PID when the profile ends, hand-set gains against the fit\n");
+  printf("%-10s %10s %10s %10s %10s\n", "", "hand_err", "fit_err", "hand_ms", "fit_ms");
+  for (const Motion& m : motions) {
+    uint32_t ms[2];
+    double err[2];
+    for (int fitted = 0; fitted < 2; fitted++) {
+      run_auton({"", [] {}});
+      if (fitted) drive_feedforward_apply(fit.left.ff, fit.right.ff);
+      uint32_t start = pros::millis();
+      m.fn();
+      sim::Pose pose = sim::world().drive.pose();
+      err[fitted] = m.target - (m.angular ? pose.theta : pose.y);
+      chassis.pid_wait();
+      ms[fitted] = pros::millis() - start;
+    }
+    const char* unit = m.angular ? "deg" : "in";
+    printf("%-10s %7.2f%-3s %7.2f%-3s %10u %10u\n", m.name, err[0], unit, err[1], unit, ms[0], ms[1]);
+  }
+
+  drive.params = saved;
+  return restored ? 0 : 1;
+}
+
+// The lift loop before ArmController: P on raw centidegrees, kP = 1
+static double old_target;
+static void old_lift_control() {
+  double error = old_target - ladyBrownSensor.get_position();
+  ladybrown.move(1 * error);
+}
+
+static int report_arm() {
+  static void (*control)() = nullptr;
+  static double overshoot, settle_at, move_start, target, direction;
+  sim::world().clock.every(10, [] {
+    if (control == nullptr) return;
+    control();
+    double pos = ladyBrownSensor.get_position() / 100.0;
+    double now = pros::millis();
+    overshoot = std::max(overshoot, (pos - target) * direction);
+    if (std::abs(pos - target) > 2) settle_at = now - move_start + 10;  // last time outside 2 deg
+  });
+
+  // The gains the robot runs
+  default_constants();
+
+  struct Controller {
+    const char* name;
+    void (*control)();
+    bool armcontroller;
+  };
+  const Controller controllers[] = {
+      {"P, kP = 1", old_lift_control, false},
+      {"ArmController", [] { lady_brown.update(); }, true},
+  };
+  const int cycle[] = {1, 2, 0};
+  const char* names[] = {"rest", "load", "score"};
+
+  printf("rest -> load -> score -> rest, settled is the last time outside 2 deg\n");
+  printf("%-16s %-8s %10s %11s %12s %10s\n", "", "move", "settled", "overshoot", "wait_until", "final");
+  for (const Controller& c : controllers) {
+    sim::reset();
+    lady_brown.state_set(0);
+    control = c.control;
+    double total = 0, worst = 0;
+    for (int state : cycle) {
+      lady_brown.state_set(state);
+      target = lady_brown.target_get();
+      direction = target >= ladyBrownSensor.get_position() / 100.0 ? 1 : -1;
+      overshoot = 0;
+      settle_at = 0;
+      move_start = pros::millis();
+      uint32_t waited = 0;
+      if (c.armcontroller) {
+        lady_brown.wait_until_settled();
+        waited = pros::millis() - move_start;
+      } else {
+        old_target = target * 100;
+      }
+      pros::delay(1500 - waited);
+      double final_pos = ladyBrownSensor.get_position() / 100.0;
+      char wait[16] = "-";
+      if (c.armcontroller) snprintf(wait, sizeof(wait), "%ums", waited);
+      printf("%-16s %-8s %8.0fms %9.1fdeg %12s %8.1fdeg\n", c.name, names[state], settle_at, overshoot, wait,
+             final_pos);
+      total += settle_at;
+      worst = std::max(worst, overshoot);
+    }
+    printf("%-16s %-8s %8.0fms %9.1fdeg\n", c.name, "cycle", total, worst);
+    control = nullptr;
+  }
+  return 0;
+}
+
+// Color sort timed from the moment a ring is seen, tuned at full speed.
+// Same classifier and detector as color_sort.cpp, only the timing differs.
+static bool fixed_delay_on;
+static int fixed_delay_power;
+static const uint32_t FIXED_DELAY = 170;  // ms, the best of 120 to 200 at full power
+static void fixed_delay_sort() {
+  static RingDetector detector;
+  static std::vector<uint32_t> eject_at;
+  static uint32_t resume_at = 0;
+  if (!fixed_delay_on) {
+    eject_at.clear();
+    return;
+  }
+  uint32_t now = pros::millis();
+  OpticalSample s = {color_checker.get_hue(), color_checker.get_saturation(), color_checker.get_proximity()};
+  if (detector.update(ring_classify(s)) == RingColor::RED) eject_at.push_back(now + FIXED_DELAY);
+  if (!eject_at.empty() && now >= eject_at.front()) {
+    intake.brake();
+    resume_at = now + COLOR_SORT_EJECT_TIME;
+    eject_at.erase(eject_at.begin());
+  }
+  if (resume_at != 0 && now >= resume_at) {
+    intake.move(fixed_delay_power);
+    resume_at = 0;
+  }
+}
+
+static int report_sort() {
+  sim::world().clock.every(COLOR_SORT_PERIOD, fixed_delay_sort);
+  color_sort_start();
+  color_sort_set(RingColor::RED);
+
+  std::mt19937 rng{15};
+  printf("20 rings a run, throwing out red\n");
+  printf("%-16s %6s %14s %14s\n", "", "power", "red thrown", "blue thrown");
+  for (const char* method : {"fixed delay", "encoder tracked"}) {
+    for (int power : {127, 100, 70}) {
+      sim::reset();
+      sim::IntakeModel& in = sim::world().intake;
+      double picked_up = 0;
+      int reds = 0;
+      for (int i = 0; i < 20; i++) {
+        int color = rng() % 2 ? 1 : 2;
+        reds += color == 1;
+        picked_up += 300 + rng() % 200;
+        in.rings.push_back({color, picked_up});
+      }
+
+      fixed_delay_on = method[0] == 'f';
+      color_sort_set(fixed_delay_on ? RingColor::NONE : RingColor::RED);
+      fixed_delay_power = power;
+      if (fixed_delay_on)
+        intake.move(power);
+      else
+        intake_set(power);
+      pros::delay(8000);
+      fixed_delay_on = false;
+      intake_set(0);
+
+      int red_thrown = 0, blue_thrown = 0;
+      for (const sim::IntakeRing& r : in.rings) {
+        if (!r.ejected) continue;
+        (r.color == 1 ? red_thrown : blue_thrown)++;
+      }
+      printf("%-16s %6d %11d/%-2d %11d/%-2d\n", method, power, red_thrown, reds, blue_thrown, 20 - reds);
+    }
+  }
+  color_sort_set(RingColor::NONE);
+  return 0;
+}
+
+// run_auton() applies default_constants(), so the mode is set inside the auton
+static SettleMode settle_report_mode;
+static void (*settle_report_fn)();
+
+static int report_settle() {
+  printf("%-20s %9s %9s %8s %9s %10s %10s\n", "auton", "timers_ms", "pred_ms", "saved", "predicted", "worst_err", "end_moved");
+  uint32_t total_timers = 0, total_pred = 0;
+  const char* last = "";
+  for (const AutonInfo& a : auton_registry) {
+    if (a.side == AutonSide::NONE) continue; // the match autons and skills
+    last = a.name;
+    settle_report_fn = a.fn;
+    settle_report_mode = SettleMode::TIMERS;
+    uint32_t timers_ms = run_auton({a.name, [] { settle_mode_set(settle_report_mode); settle_report_fn(); }});
+    sim::Pose timers = sim::world().drive.pose();
+    settle_report_mode = SettleMode::PREDICT;
+    uint32_t pred_ms = run_auton({a.name, [] { settle_mode_set(settle_report_mode); settle_report_fn(); }});
+    sim::Pose pred = sim::world().drive.pose();
+    SettleStats st = settle_stats();
+
+    total_timers += timers_ms;
+    total_pred += pred_ms;
+    printf("%-20s %9u %9u %7.1f%% %5d/%-3d %8.2f %8.2fin\n", a.name, timers_ms, pred_ms,
+           100.0 * ((double)timers_ms - pred_ms) / timers_ms, st.predicted, st.motions, st.error_max,
+           std::hypot(pred.x - timers.x, pred.y - timers.y));
+  }
+  printf("%-20s %9u %9u %7.1f%%\n", "total", total_timers, total_pred, 100.0 * ((double)total_timers - total_pred) / total_timers);
+
+  // The last run's motions
+  printf("\n%s\n", last);
+  settle_stats_print();
+  return 0;
+}
+
+// The table the brain shows a page at a time, the sim picks the fastest
+static int report_autotune() {
+  run_auton({"", [] {}});
+  for (TuneLoop loop : {TuneLoop::TURN, TuneLoop::DRIVE, TuneLoop::SWING}) {
+    AutotuneResult r = pid_autotune(loop);
+    if (!r.relay.ok) {
+      printf("%s: no oscillation\n", tune_loop_name(loop));
+      continue;
+    }
+    printf("%s: Ku %.3f  Tu %.3f s  amplitude %.2f\n", tune_loop_name(loop), r.relay.ku, r.relay.tu, r.relay.amplitude);
+    for (int i = 0; i < AUTOTUNE_CANDIDATES; i++) {
+      const TuneCandidate& c = r.candidates[i];
+      printf("  %c %-15s p %7.3f  i %7.4f  d %7.3f  %5lums  error %6.2f %s\n", i == r.chosen ? '*' : ' ', c.name,
+             c.constants.kp, c.constants.ki, c.constants.kd, (unsigned long)c.ms, c.error,
+             c.settled ? "" : "(didn't settle)");
+    }
+    pid_autotune_apply(loop, r.candidates[r.chosen].constants);
+  }
+
+  // Nothing runs without the drive width
+  run_auton({"", [] {}});
+  chassis.drive_width_set(0.0);
+  const char* unready = pid_autotune_unready();
+  bool refused = unready != nullptr && !pid_autotune(TuneLoop::TURN).relay.ok;
+  printf("\nno drive width: %s\n", refused ? unready : "RAN");
+  return refused ? 0 : 1;
+}
+
+// What the field view (include/organiz/field_view.h) invalidates a frame
+// while the robot drives, from the robot outline's old and new boxes. The
+// naive view redraws the whole field canvas every frame.
+static int report_field() {
+  static FieldProjection proj;
+  static RobotMarker shown;
+  static int64_t px_sum;
+  static int32_t px_max;
+  static int frames, redraws;
+  sim::world().clock.every(FIELD_VIEW_PERIOD, [] {
+    OdomState s = odom_state();
+    RobotMarker m = robot_marker(proj, s.x, s.y, s.theta, FIELD_ROBOT_LENGTH, FIELD_ROBOT_WIDTH);
+    frames++;
+    if (m == shown) return;
+    int32_t px = moved_area(rect_bounds(shown.points, ROBOT_MARKER_POINTS, FIELD_LINE_WIDTH / 2),
+                           rect_bounds(m.points, ROBOT_MARKER_POINTS, FIELD_LINE_WIDTH / 2));
+    shown = m;
+    px_sum += px;
+    px_max = std::max(px_max, px);
+    redraws++;
+  });
+
+  const int32_t field_px = FIELD_VIEW_PX * FIELD_VIEW_PX;
+  printf("%-20s %7s %8s %10s %8s %10s\n", "auton", "frames", "redraws", "px/frame", "max_px", "vs_field");
+  for (const auto& pair : mirrored) {
+    shown = robot_marker(proj, 0, 0, 0, FIELD_ROBOT_LENGTH, FIELD_ROBOT_WIDTH);
+    px_sum = px_max = frames = redraws = 0;
+    run_auton(pair[0]);
+    double per_frame = (double)px_sum / frames;
+    printf("%-20s %7d %8d %10.0f %8d %9.1f%%\n", pair[0].name, frames, redraws, per_frame, px_max, 100.0 * per_frame / field_px);
+  }
+  return 0;
+}
+
+// The store has to give back exactly what was saved, and turn away a file
+// that's been changed or saved over other default_constants()
+static int check_config(const char* path) {
+  run_auton({"", [] {}});
+  config_defaults_mark();
+  RobotConfig saved = config_capture();
+  if (!config_save(path)) {
+    printf("can't write %s\n", path);
+    return 1;
+  }
+
+  // Something else running, as if the code changed since the save
+  chassis.pid_turn_constants_set(1, 0, 1);
+  chassis.slew_swing_constants_forward_set(1_deg, 10);
+  chassis.pid_drive_chain_forward_constant_set(9);
+  lady_brown.pid.exit_condition_set(1, 1);
+  settle_mode_set(SettleMode::TIMERS);
+  odom_integrator_set(OdomIntegrator::EULER);
+
+  auto start = std::chrono::steady_clock::now();
+  bool loaded = config_load(path);
+  double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  RobotConfig now = config_capture();
+  bool same = loaded && memcmp(&saved, &now, sizeof(RobotConfig)) == 0;
+  printf("%s: %zu bytes, loaded in %.0f us, constants %s\n", path, sizeof(ConfigHeader) + sizeof(RobotConfig), us,
+         same ? "match" : "DIFFER");
+
+  // A flipped byte fails the checksum and changes nothing
+  FILE* f = fopen(path, "r+b");
+  fseek(f, sizeof(ConfigHeader) + 8, SEEK_SET);
+  fputc(0x5a, f);
+  fclose(f);
+  chassis.pid_turn_constants_set(1, 0, 1);
+  bool rejected = !config_load(path) && chassis.turnPID.constants.kp == 1;
+  printf("corrupted copy %s\n", rejected ? "rejected" : "LOADED");
+
+  // An edit to default_constants() after the save wins over the file
+  config_save(path);
+  chassis.pid_turn_constants_set(3, 0, 20);
+  config_defaults_mark();
+  bool stale = !config_load(path) && chassis.turnPID.constants.kp == 3;
+  printf("copy saved over other defaults %s\n", stale ? "rejected" : "LOADED");
+  return same && rejected && stale ? 0 : 1;
+}
+
+static int list_autons() {
+  printf("%-3s %-26s %-5s %-10s %9s\n", "#", "auton", "color", "side", "expected");
+  for (size_t i = 0; i < auton_registry.size(); i++) {
+    const AutonInfo& a = auton_registry[i];
+    printf("%-3zu %-26s %-5s %-10s %9u\n", i, a.name, alliance_name(a.alliance), auton_side_name(a.side), a.expected_ms);
+  }
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  int runs = 1;
+  const char* filter = nullptr;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--characterized"))
+      characterized = true;
+    else if (!strcmp(argv[i], "--list"))
+      return list_autons();
+    else if (!strcmp(argv[i], "--mirror"))
+      return check_mirror();
+    else if (!strcmp(argv[i], "--chain"))
+      return report_chaining();
+    else if (!strcmp(argv[i], "--profile"))
+      return report_profiles();
+    else if (!strcmp(argv[i], "--width"))
+      return report_width();
+    else if (!strcmp(argv[i], "--path"))
+      return report_path();
+    else if (!strcmp(argv[i], "--drift"))
+      return report_drift();
+    else if (!strcmp(argv[i], "--ekf"))
+      return report_ekf();
+    else if (!strcmp(argv[i], "--reloc"))
+      return report_reloc();
+    else if (!strcmp(argv[i], "--characterize"))
+      return report_characterize(i + 1 < argc ? argv[i + 1] : nullptr);
+    else if (!strcmp(argv[i], "--timeline"))
+      return report_timeline();
+    else if (!strcmp(argv[i], "--settle"))
+      return report_settle();
+    else if (!strcmp(argv[i], "--autotune"))
+      return report_autotune();
+    else if (!strcmp(argv[i], "--sort"))
+      return report_sort();
+    else if (!strcmp(argv[i], "--arm"))
+      return report_arm();
+    else if (!strcmp(argv[i], "--odom"))
+      return report_odom();
+    else if (!strcmp(argv[i], "--field"))
+      return report_field();
+    else if (!strcmp(argv[i], "--config") && i + 1 < argc)
+      return check_config(argv[i + 1]);
+    else if (!strcmp(argv[i], "--pack") && i + 1 < argc)
+      return write_pack(argv[i + 1]);
+    else if (!strcmp(argv[i], "--runs") && i + 1 < argc)
+      runs = std::atoi(argv[++i]);
+    else
+      filter = argv[i];
+  }
+  if (runs < 1) runs = 1;
+
+  printf("%-26s %9s %9s %8s %8s %8s %8s %8s %8s %s\n", "auton", "time_ms", "expected", "x", "y", "theta", "odom_x", "odom_y", "odom_t", "interfered");
+  for (const AutonInfo& a : auton_registry) {
+    if (filter && !strstr(a.name, filter)) continue;
+
+    auto wall_start = std::chrono::steady_clock::now();
+    uint32_t ms = 0;
+    for (int i = 0; i < runs; i++) ms = run_auton(a);
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+
+    sim::Pose p = sim::world().drive.pose();
+    ez::pose o = chassis.odom_pose_get();
+    printf("%-26s %9u %9u %8.2f %8.2f %8.2f %8.2f %8.2f %8.2f %s", a.name, ms, a.expected_ms, p.x, p.y, p.theta, o.x, o.y, o.theta, chassis.interfered ? "yes" : "no");
+    if (runs > 1) printf("  (%.0f runs/s)", runs / wall);
+    printf("\n");
+  }
+  return 0;
+}
@@ -0,0 +1,157 @@
+#include <cassert>
+#include <cmath>
+
+#include "sim.hpp"
+
+namespace sim {
+
+///
+// Clock
+///
+void Clock::every(uint32_t period_ms, Callback fn) {
+  periodic.push_back({period_ms, millis() + period_ms, std::move(fn)});
+}
+
+void Clock::advance(uint32_t ms) {
+  // A periodic callback calling pros::delay would recurse forever
+  assert(!advancing && "pros::delay called from inside a simulated task");
+  advancing = true;
+  for (uint32_t i = 0; i < ms; i++) {
+    now_us += 1000;
+    uint32_t now = millis();
+    for (auto& p : periodic) {
+      if (now >= p.next) {
+        p.next += p.period;
+        p.fn();
+      }
+    }
+  }
+  advancing = false;
+}
+
+void Clock::reset() {
+  now_us = 0;
+  for (auto& p : periodic) p.next = p.period;
+}
+
+///
+// Drive model
+///
+void DriveModel::command(double left, double right) {
+  ul = std::fmax(-1.0, std::fmin(1.0, left));
+  ur = std::fmax(-1.0, std::fmin(1.0, right));
+}
+
+void DriveModel::step(double dt) {
+  auto side = [&](double u, double v) {
+    double target = u * params.free_speed;
+    double tau = params.time_constant;
+    if (u == 0.0) tau = brake_hold ? params.hold_time_constant : params.coast_time_constant;
+
+    // Friction opposes motion, and holds the robot still until the motors beat it
+    double drag = params.friction * params.free_speed;
+    if (v != 0.0)
+      target -= v > 0 ? drag : -drag;
+    else
+      target = (target > 0 ? 1 : -1) * std::fmax(0.0, std::fabs(target) - drag);
+    double next = v + (target - v) * (dt / (tau + dt));
+    if (v != 0.0 && (next > 0) != (v > 0) && std::fabs(u * params.free_speed) <= drag) next = 0.0;
+    return next;
+  };
+  vl = side(ul, vl);
+  vr = side(ur, vr);
+
+  double dl = vl * dt;
+  double dr = vr * dt;
+  pl += dl;
+  pr += dr;
+
+  // Exact arc integration, clockwise positive
+  double dtheta = (dl - dr) / params.track_width;
+  double ds = (dl + dr) / 2.0;
+  double chord = std::fabs(dtheta) < 1e-9 ? ds : 2.0 * ds / dtheta * std::sin(dtheta / 2.0);
+  double mid = truth.theta * M_PI / 180.0 + dtheta / 2.0;
+  truth.x += chord * std::sin(mid);
+  truth.y += chord * std::cos(mid);
+  truth.theta += dtheta * 180.0 / M_PI;
+
+  drift += params.gyro_drift * dt;
+}
+
+void DriveModel::reset(Pose start) {
+  truth = start;
+  ul = ur = vl = vr = pl = pr = drift = 0.0;
+}
+
+double DriveModel::noise(double stddev) {
+  if (stddev <= 0.0) return 0.0;
+  return std::normal_distribution<double>(0.0, stddev)(rng);
+}
+
+double DriveModel::left_position() { return pl * params.encoder_scale + noise(params.encoder_noise); }
+double DriveModel::right_position() { return pr * params.encoder_scale + noise(params.encoder_noise); }
+double DriveModel::heading() { return truth.theta + drift + noise(params.gyro_noise); }
+double DriveModel::gyro_rate() const { return (vl - vr) / params.track_width * 180.0 / M_PI + params.gyro_drift; }
+
+// Current rises with the gap between commanded and back-emf voltage
+double DriveModel::left_current() const { return params.stall_current * std::fmin(1.0, std::fabs(ul - vl / params.free_speed)); }
+double DriveModel::right_current() const { return params.stall_current * std::fmin(1.0, std::fabs(ur - vr / params.free_speed)); }
+
+///
+// Mechanism motors
+///
+void MotorModel::step(double dt) {
+  rpm += (command * free_rpm - rpm) * (dt / (time_constant + dt));
+  rpm -= gravity * std::cos((position - level) * M_PI / 180.0) * dt;
+  position += rpm * 6.0 * dt;  // rpm -> deg/s
+}
+
+///
+// Intake
+///
+void IntakeModel::step() {
+  if (motor == nullptr) return;
+  for (IntakeRing& r : rings) {
+    if (r.ejected || r.scored) continue;
+    double place = motor->position - r.picked_up;
+    if (place < top) continue;
+    if (std::fabs(motor->rpm) < motor->free_rpm / 2 && place < top + throw_span)
+      r.ejected = true;
+    else if (place >= top + throw_span)
+      r.scored = true;
+  }
+}
+
+const IntakeRing* IntakeModel::at_sensor(double position) const {
+  for (const IntakeRing& r : rings) {
+    double place = position - r.picked_up;
+    if (place >= sensor_at && place <= sensor_at + sensor_span) return &r;
+  }
+  return nullptr;
+}
+
+///
+// World
+///
+World& world() {
+  static World w;
+  // Physics runs at 1 ms, ahead of any control loop registered later
+  static const bool physics_registered = (w.clock.every(1, [] {
+    w.drive.step(0.001);
+    for (auto m : w.motors) m->step(0.001);
+    w.intake.step();
+  }), true);
+  (void)physics_registered;
+  return w;
+}
+
+void reset(Pose start) {
+  World& w = world();
+  w.clock.reset();
+  w.drive.reset(start);
+  for (auto m : w.motors) m->reset();
+  w.intake.rings.clear();
+  for (auto& fn : w.on_reset) fn();
+}
+
+}  // namespace sim
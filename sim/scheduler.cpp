@@ -0,0 +1,53 @@
+#include "main.h"
+
+// Host stand-in for src/organiz/scheduler.cpp. A PeriodicLoop becomes a
+// sim clock callback at its period, which is what the task amounts to on
+// an idle brain. Jitter and deadline misses are always zero here.
+
+static LoopTimer* loops[LOOP_TIMERS_MAX];
+static int loop_count = 0;
+static int loops_unlisted = 0;
+
+LoopTimer::LoopTimer(const char* name, uint32_t period_ms) : name(name), period(period_ms) {
+  if (loop_count < LOOP_TIMERS_MAX)
+    loops[loop_count++] = this;
+  else
+    loops_unlisted++;
+}
+
+void LoopTimer::wait() {
+  uint32_t now = pros::millis();
+  if (!started || now > release_ms + period) {
+    started = true;
+    release_ms = now;
+  }
+  release_ms += period;
+  pros::delay(release_ms - now);
+  loop_stats.iterations++;
+}
+
+void LoopTimer::stats_reset() {
+  loop_stats = LoopStats();
+  started = false;
+}
+
+PeriodicLoop::PeriodicLoop(const char* name, uint32_t period_ms, std::function<void()> body, uint32_t priority)
+    : timer(name, period_ms), body(body), priority(priority) {}
+
+void PeriodicLoop::start() {
+  is_running = true;
+  if (task == nullptr) {
+    // Never dereferenced, only marks the loop as registered
+    task = reinterpret_cast<pros::Task*>(this);
+    sim::world().clock.every(timer.period_get(), [this] {
+      if (is_running) body();
+    });
+  }
+}
+
+void PeriodicLoop::pause() { is_running = false; }
+
+void loop_stats_print() {
+  for (int i = 0; i < loop_count; i++) printf("%-12s %3ums\n", loops[i]->name_get(), loops[i]->period_get());
+  if (loops_unlisted > 0) printf("%d more loops not listed, raise LOOP_TIMERS_MAX\n", loops_unlisted);
+}
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "organiz/pose_ekf.h"
+#include "organiz/telemetry_format.h"
+
+// Replays a telemetry recording through PoseEkf and times each kind of
+// update. The recording's tracking wheels and IMU drive the filter, and its
+// odom pose stands in for GPS fixes and distance readings so every update
+// runs. Without a file it replays a synthetic minute of driving.
+//
+//   make ekf_bench && ./bin/ekf_bench [tlm_NNN.bin] [track width, in]
+
+static const FieldSegment walls[] = {{-72, -72, 72, -72}, {72, -72, 72, 72}, {72, 72, -72, 72}, {-72, 72, -72, -72}};
+static const RangeMount mount = {7, 0, 0};
+
+static bool load(const char* path, std::vector<TelemetrySample>& out) {
+    FILE* f = fopen(path, "rb");
+    if (f == nullptr) {
+        perror(path);
+        return false;
+    }
+    TelemetryHeader header;
+    if (fread(&header, sizeof(header), 1, f) != 1 || header.magic != TELEMETRY_MAGIC ||
+        header.version != TELEMETRY_VERSION || header.sample_size != sizeof(TelemetrySample)) {
+        fprintf(stderr, "%s: not a version %u telemetry file\n", path, TELEMETRY_VERSION);
+        fclose(f);
+        return false;
+    }
+    TelemetrySample s;
+    while (fread(&s, sizeof(s), 1, f) == 1) out.push_back(s);
+    fclose(f);
+    return true;
+}
+
+// Arcs around the middle of the field at 10 ms, like the recorder writes
+static void synthesize(std::vector<TelemetrySample>& out, double width) {
+    double x = 0, y = -40, theta = 90, left = 0, right = 0;
+    for (uint32_t t = 0; t < 60000; t += 10) {
+        double s = t / 1000.0;
+        double v = 50 * std::sin(s * 0.7), w = 80 * std::sin(s * 0.23); // in/s, deg/s
+        double d = v * 0.01, d_theta = w * 0.01;
+        double mid = (theta + d_theta / 2) * M_PI / 180;
+        x += d * std::sin(mid);
+        y += d * std::cos(mid);
+        theta += d_theta;
+        left += d + d_theta * M_PI / 180 * width / 2;
+        right += d - d_theta * M_PI / 180 * width / 2;
+
+        TelemetrySample sample = {};
+        sample.time_ms = t;
+        sample.x = x;
+        sample.y = y;
+        sample.theta = theta;
+        sample.sensor_left = left;
+        sample.sensor_right = right;
+        sample.imu = theta;
+        out.push_back(sample);
+    }
+}
+
+int main(int argc, char** argv) {
+    double width = argc > 2 ? std::atof(argv[2]) : 12.0;
+    std::vector<TelemetrySample> log;
+    if (argc > 1) {
+        if (!load(argv[1], log)) return 1;
+    } else {
+        synthesize(log, width);
+    }
+    if (log.size() < 2) {
+        fprintf(stderr, "recording too short\n");
+        return 1;
+    }
+
+    using clock = std::chrono::steady_clock;
+    double step_s = 0, gps_s = 0, range_s = 0;
+    int steps = 0, fixes = 0, ranges = 0;
+    double max_gap = 0;
+    int lost_fix_taken = 0;
+
+    PoseEkf ekf;
+    ekf.reset(log[0].x, log[0].y, log[0].imu);
+    for (size_t i = 1; i < log.size(); i++) {
+        const TelemetrySample& a = log[i - 1];
+        const TelemetrySample& b = log[i];
+        double dl = b.sensor_left - a.sensor_left, dr = b.sensor_right - a.sensor_right;
+        double dt = (b.time_ms - a.time_ms) / 1000.0;
+
+        auto start = clock::now();
+        ekf.step((dl + dr) / 2, (dl - dr) / width * 180 / M_PI, dt);
+        ekf.update_heading(b.imu);
+        step_s += std::chrono::duration<double>(clock::now() - start).count();
+        steps++;
+
+        if (i % 2 == 0) {
+            start = clock::now();
+            ekf.update_position(b.x, b.y);
+            gps_s += std::chrono::duration<double>(clock::now() - start).count();
+            fixes++;
+        }
+        // A GPS without a fix, as odometry.cpp hands it on, must not get in
+        if (i % 7 == 0 && ekf.update_position(INFINITY, INFINITY, INFINITY)) lost_fix_taken++;
+        if (i % 5 == 0) {
+            double reading = field_ray_cast(b.x, b.y, b.theta, mount, walls, 4);
+            if (reading > 0) {
+                start = clock::now();
+                ekf.update_range(mount, reading, walls, 4);
+                range_s += std::chrono::duration<double>(clock::now() - start).count();
+                ranges++;
+            }
+        }
+        max_gap = std::max(max_gap, std::hypot(ekf.x() - b.x, ekf.y() - b.y));
+    }
+
+    printf("%zu samples, %.1f s, largest gap from the recorded pose %.2f in\n", log.size(),
+           (log.back().time_ms - log.front().time_ms) / 1000.0, max_gap);
+    printf("%-26s %10s\n", "update", "us/call");
+    printf("%-26s %10.3f\n", "step + update_heading", step_s / steps * 1e6);
+    if (fixes) printf("%-26s %10.3f\n", "update_position", gps_s / fixes * 1e6);
+    if (ranges) printf("%-26s %10.3f\n", "update_range", range_s / ranges * 1e6);
+    bool finite = std::isfinite(ekf.x()) && std::isfinite(ekf.y()) && std::isfinite(ekf.theta());
+    if (lost_fix_taken > 0 || !finite) printf("GPS readings with no fix got into the filter\n");
+    return lost_fix_taken == 0 && finite ? 0 : 1;
+}
@@ -0,0 +1,48 @@
+#include <cstdio>
+#include <vector>
+
+#include "organiz/feedforward_fit.h"
+
+// Fits kS, kV and kA per side from a drive characterization log, the same
+// fit the brain runs after the tests. The fit goes to stdout in
+// /usd/feedforward.txt's format, the quality of it to stderr.
+//
+//   make ff_fit && ./bin/ff_fit char_000.bin > feedforward.txt
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s char_NNN.bin\n", argv[0]);
+        return 2;
+    }
+
+    FILE* f = fopen(argv[1], "rb");
+    if (f == nullptr) {
+        perror(argv[1]);
+        return 1;
+    }
+    CharacterizeHeader header;
+    if (fread(&header, sizeof(header), 1, f) != 1 || header.magic != CHARACTERIZE_MAGIC ||
+        header.version != CHARACTERIZE_VERSION || header.sample_size != sizeof(CharacterizeSample)) {
+        fprintf(stderr, "%s: not a version %u characterization log\n", argv[1], CHARACTERIZE_VERSION);
+        fclose(f);
+        return 1;
+    }
+    std::vector<CharacterizeSample> log;
+    CharacterizeSample s;
+    while (fread(&s, sizeof(s), 1, f) == 1) log.push_back(s);
+    fclose(f);
+
+    FeedforwardFit left, right;
+    feedforward_fit_log(log.data(), log.size(), left, right);
+    if (left.samples == 0 || right.samples == 0) {
+        fprintf(stderr, "%s: %zu samples, not enough moving to fit\n", argv[1], log.size());
+        return 1;
+    }
+
+    fprintf(stderr, "%zu samples, %.1f s\n", log.size(), (log.back().time_ms - log.front().time_ms) / 1000.0);
+    fprintf(stderr, "left  r2 %.4f over %d samples\n", left.r2, left.samples);
+    fprintf(stderr, "right r2 %.4f over %d samples\n", right.r2, right.samples);
+    // Same format as drive_feedforward_save()
+    printf("left %f %f %f\nright %f %f %f\n", left.ff.kS, left.ff.kV, left.ff.kA, right.ff.kS, right.ff.kV, right.ff.kA);
+    return 0;
+}
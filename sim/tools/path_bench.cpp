@@ -0,0 +1,212 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+#include "organiz/path_follower.h"
+#include "organiz/path_plan.h"
+
+// Per-tick cost of the pure pursuit lookups on a long injected path: the old
+// full scan from testfile.cpp against PathCursor. Then the cost of planning a
+// path: EZ's inject and smooth through vectors against PathCache, the first
+// time and once it's cached.
+//
+//   make path_bench && ./bin/path_bench
+
+static const double LOOKAHEAD = 12; // in
+
+// What Drivetrain::followPath did before: hypot over every point, then walk forward
+static size_t full_scan(const std::vector<PathPoint>& path, double x, double y, PathPoint& target) {
+    size_t closest_index = 0;
+    double closest_distance = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < path.size(); ++i) {
+        double distance = std::hypot(path[i].x - x, path[i].y - y);
+        if (distance < closest_distance) {
+            closest_distance = distance;
+            closest_index = i;
+        }
+    }
+
+    size_t lookahead_index = closest_index;
+    while (lookahead_index < path.size() - 1) {
+        double dx = path[lookahead_index + 1].x - x;
+        double dy = path[lookahead_index + 1].y - y;
+        if (dx * dx + dy * dy > LOOKAHEAD * LOOKAHEAD) break;
+        lookahead_index++;
+    }
+    target = path[lookahead_index];
+    return closest_index;
+}
+
+// An odom movement the size of EZ's, which its path functions copy around
+struct EzOdom {
+    double x, y, theta;
+    int direction, speed, behavior;
+};
+
+// What pid_odom_smooth_pp_set() does: inject into a new vector, then sweep
+// copies by value until a sweep moves less than the tolerance
+static std::vector<EzOdom> ez_inject(std::vector<EzOdom> movements) {
+    std::vector<EzOdom> path;
+    for (size_t i = 0; i + 1 < movements.size(); i++) {
+        const EzOdom& a = movements[i];
+        const EzOdom& b = movements[i + 1];
+        int steps = (int)std::ceil(std::hypot(b.x - a.x, b.y - a.y) / PATH_SPACING);
+        for (int s = 0; s < steps; s++) {
+            double t = (double)s / steps;
+            path.push_back({a.x + t * (b.x - a.x), a.y + t * (b.y - a.y), 0, b.direction, b.speed, b.behavior});
+        }
+    }
+    path.push_back(movements.back());
+    return path;
+}
+
+static std::vector<EzOdom> ez_smooth(std::vector<EzOdom> path, const PathSmoothing& s, int& sweeps) {
+    std::vector<EzOdom> smooth = path;
+    double change = s.tolerance;
+    sweeps = 0;
+    while (change >= s.tolerance) {
+        change = 0;
+        for (size_t i = 1; i + 1 < path.size(); i++) {
+            double x = smooth[i].x;
+            double y = smooth[i].y;
+            smooth[i].x += s.weight_data * (path[i].x - x) + s.weight_smooth * (smooth[i - 1].x + smooth[i + 1].x - 2 * x);
+            smooth[i].y += s.weight_data * (path[i].y - y) + s.weight_smooth * (smooth[i - 1].y + smooth[i + 1].y - 2 * y);
+            change += std::fabs(smooth[i].x - x) + std::fabs(smooth[i].y - y);
+        }
+        sweeps++;
+    }
+    return smooth;
+}
+
+static PathCache cache; // 270 KB, too big for the stack
+
+// A skills length path, about 280 in
+static bool plan_bench() {
+    const PathPoint waypoints[] = {{0, 0},   {0, 24},   {24, 48},  {48, 48}, {72, 24},
+                                   {72, -24}, {48, -48}, {0, -48}, {-24, -24}};
+    const size_t count = std::size(waypoints);
+    const int runs = 200;
+    PathSmoothing smoothing;
+
+    std::vector<EzOdom> movements;
+    for (const PathPoint& w : waypoints) movements.push_back({w.x, w.y, 0, 0, 110, 0});
+    std::vector<EzOdom> ez_path;
+    int ez_sweeps = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < runs; r++) ez_path = ez_smooth(ez_inject(movements), smoothing, ez_sweeps);
+    double ez_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / runs;
+
+    // Fresh plans, a different path every run so none of them hit
+    double cold_s = 0;
+    PlannedPath* path = nullptr;
+    for (int r = 0; r < runs; r++) {
+        smoothing.tolerance = 0.0001 + r * 1e-12;
+        start = std::chrono::steady_clock::now();
+        path = cache.plan(waypoints, count, smoothing);
+        while (!path_smooth_step(*path, 25)) {}
+        cold_s += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    cold_s /= runs;
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < runs; r++) {
+        if (cache.plan(waypoints, count, smoothing) != path) return false;
+    }
+    double hit_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / runs;
+
+    double worst = 0;
+    for (size_t i = 0; i < path->count; i++) {
+        worst = std::fmax(worst, std::hypot(path->smooth[i].x - ez_path[i].x, path->smooth[i].y - ez_path[i].y));
+    }
+    printf("\n%zu waypoints, %zu points\n", count, path->count);
+    printf("EZ inject + smooth  %8.1f us  %d sweeps\n", ez_s * 1e6, ez_sweeps);
+    printf("PathCache, new      %8.1f us  %d sweeps\n", cold_s * 1e6, path->sweeps);
+    printf("PathCache, cached   %8.3f us\n", hit_s * 1e6);
+    printf("largest difference from EZ's path %.6f in\n", worst);
+    return ez_path.size() == path->count && worst < 1e-9;
+}
+
+// A robot knocked 20 in off a straight 200 in path, out of the lookahead's
+// reach. It should aim back at the closest point every tick, not at a
+// target that runs down the path while it sits there.
+static bool off_path_check() {
+    std::vector<PathPoint> path = inject_points({{0, 0}, {0, 200}});
+    PathCursor<PathPoint> cursor;
+    cursor.reset(path.data(), path.size());
+
+    // closest() catches up a window at a time, the target should follow it
+    // and stop at y = 40
+    double worst = 0, ty = 0;
+    for (int tick = 0; tick < 5; tick++) {
+        double tx = 0;
+        const PathPoint& c = path[cursor.closest(20, 40)];
+        cursor.lookahead(20, 40, LOOKAHEAD, tx, ty);
+        worst = std::fmax(worst, std::hypot(tx - c.x, ty - c.y));
+    }
+    bool held = std::fabs(ty - 40) < 1e-9;
+
+    // And back on the path it picks up from there
+    double tx = 0;
+    cursor.closest(0, 40);
+    cursor.lookahead(0, 40, LOOKAHEAD, tx, ty);
+    bool rejoined = std::fabs(tx) < 1e-9 && std::fabs(ty - 40 - LOOKAHEAD) < 1e-9;
+
+    printf("\noff the path, target strays %.3f in from the closest point, held %s\n", worst, held ? "yes" : "no");
+    printf("back on the path, target at (%.1f, %.1f)\n", tx, ty);
+    return worst < 1e-9 && held && rejoined;
+}
+
+// No path yet: lookahead() says so and aims at the robot, not at garbage
+static bool empty_path_check() {
+    PathCursor<PathPoint> cursor;
+    double tx = -1, ty = -1;
+    bool found = cursor.lookahead(3, 4, LOOKAHEAD, tx, ty);
+    printf("no path, lookahead %s at (%.1f, %.1f)\n", found ? "found" : "not found", tx, ty);
+    return !found && tx == 3 && ty == 4;
+}
+
+int main() {
+    // A 5000 in zig-zag, 10k points at PATH_SPACING
+    std::vector<PathPoint> waypoints;
+    for (int i = 0; i <= 50; i++) waypoints.push_back({(i % 2) * 30.0, i * 95.0});
+    std::vector<PathPoint> path = inject_points(waypoints);
+
+    // The robot rides 1 in off the path, one tick per point
+    std::vector<PathPoint> poses;
+    for (size_t i = 0; i < path.size(); i++) poses.push_back({path[i].x + 1, path[i].y});
+
+    volatile double sink = 0;
+    size_t mismatched = 0;
+    std::vector<size_t> scan_closest(poses.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < poses.size(); i++) {
+        PathPoint target;
+        scan_closest[i] = full_scan(path, poses[i].x, poses[i].y, target);
+        sink = sink + target.x;
+    }
+    double scan_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    PathCursor<PathPoint> cursor;
+    cursor.reset(path.data(), path.size());
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < poses.size(); i++) {
+        double tx = 0, ty = 0;
+        size_t closest = cursor.closest(poses[i].x, poses[i].y);
+        cursor.lookahead(poses[i].x, poses[i].y, LOOKAHEAD, tx, ty);
+        sink = sink + tx;
+        if (closest != scan_closest[i]) mismatched++;
+    }
+    double cursor_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double n = poses.size();
+    printf("%zu points, %zu ticks\n", path.size(), poses.size());
+    printf("full scan   %10.0f ns/tick\n", scan_s / n * 1e9);
+    printf("PathCursor  %10.0f ns/tick  (%.0fx)\n", cursor_s / n * 1e9, scan_s / cursor_s);
+    printf("closest index differs from the full scan on %zu ticks\n", mismatched);
+    bool off_path = off_path_check();
+    bool empty = empty_path_check();
+    bool planned = plan_bench();
+    return mismatched == 0 && off_path && empty && planned ? 0 : 1;
+}
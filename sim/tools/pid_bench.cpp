@@ -0,0 +1,154 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "organiz/pid_bank.h"
+
+// Per-tick cost of computing every drive controller: one ez::PID-style
+// object each, against a PidBank on the same inputs.
+//
+//   make pid_bench && ./bin/pid_bench
+
+static const int CONTROLLERS = 20; // ez::Drive's PIDs
+static const int TICKS = 20000;    // 200 s at 10 ms
+static const int REPEATS = 20;
+
+// ez::PID's fields and compute(), name and exit timers included
+struct EzPid {
+    struct Constants {
+        double kp = 0, ki = 0, kd = 0, start_i = 0;
+    } constants;
+    struct Exit {
+        int small_exit_time = 0, big_exit_time = 0, velocity_exit_time = 0, mA_timeout = 0;
+        double small_error = 0, big_error = 0, open_loop_timeout = 0;
+    } exit;
+    double output = 0, cur = 0, error = 0, target = 0, prev_error = 0, integral = 0, derivative = 0;
+    long time = 0, prev_time = 0;
+    double prev_current = 0;
+    int i = 0, j = 0, k = 0, l = 0, m = 0;
+    bool is_mA = false;
+    std::string name;
+
+    double compute(double current) {
+        error = target - current;
+        derivative = prev_current - current;
+        if (constants.ki != 0) {
+            if (std::fabs(error) < constants.start_i) integral += error;
+            if ((error > 0) - (error < 0) != (prev_error > 0) - (prev_error < 0)) integral = 0;
+        }
+        output = error * constants.kp + integral * constants.ki + derivative * constants.kd;
+        prev_current = current;
+        prev_error = error;
+        return output;
+    }
+};
+
+struct Gains {
+    const char* name;
+    double kp, ki, kd, start_i;
+};
+
+// default_constants() in src/autons.cpp and lady_brown's, cycled to fill the drive
+static const Gains GAINS[] = {
+    {"heading", 4, 0, 20, 0},        {"forward drive", 2, 0, 35, 0}, {"backward drive", 2.5, 0.007, 20, 1},
+    {"turn", 3.4, 0.002, 16, 1},     {"swing forward", 5, 0, 30, 0}, {"swing backward", 5, 0, 30, 0},
+    {"lady brown", 3, 0, 10, 0},
+};
+
+int main() {
+    // Closed loop through the double objects once, each controller driving
+    // a first order plant toward a target that steps every 2 s. The inputs
+    // it saw are replayed to every version, outputs kept as the reference.
+    std::vector<EzPid> pids(CONTROLLERS);
+    for (int c = 0; c < CONTROLLERS; c++) {
+        const Gains& g = GAINS[c % std::size(GAINS)];
+        pids[c].constants = {g.kp, g.ki, g.kd, g.start_i};
+        pids[c].name = g.name;
+    }
+    std::vector<float> inputs(TICKS * CONTROLLERS), targets(TICKS * CONTROLLERS), reference(TICKS * CONTROLLERS);
+    std::vector<double> plant(CONTROLLERS, 0);
+    for (int t = 0; t < TICKS; t++) {
+        for (int c = 0; c < CONTROLLERS; c++) {
+            int n = t * CONTROLLERS + c;
+            pids[c].target = ((t / 200 + c) % 5 - 2) * 24.0;
+            targets[n] = pids[c].target;
+            inputs[n] = plant[c];
+            reference[n] = pids[c].compute(inputs[n]);
+            double out = std::fmax(-127, std::fmin(127, reference[n]));
+            plant[c] += (out * 0.5 - (plant[c] - (t > 0 ? inputs[n - CONTROLLERS] : 0)) * 4) * 0.01;
+        }
+    }
+
+    volatile double sink = 0;
+
+    // Before: a compute() call per object
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < REPEATS; r++) {
+        for (auto& pid : pids) pid.integral = pid.prev_error = pid.prev_current = 0;
+        for (int t = 0; t < TICKS; t++) {
+            const float* in = &inputs[t * CONTROLLERS];
+            const float* tg = &targets[t * CONTROLLERS];
+            double sum = 0;
+            for (int c = 0; c < CONTROLLERS; c++) {
+                pids[c].target = tg[c];
+                sum += pids[c].compute(in[c]);
+            }
+            sink = sink + sum;
+        }
+    }
+    double ez_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // After: one pass over the bank, the same inputs in and outputs out
+    auto run_bank = [&](auto& bank, double& worst) {
+        for (int c = 0; c < CONTROLLERS; c++) {
+            const Gains& g = GAINS[c % std::size(GAINS)];
+            bank.add(g.name, g.kp, g.ki, g.kd, g.start_i);
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < REPEATS; r++) {
+            for (int c = 0; c < CONTROLLERS; c++) bank.variables_reset(c);
+            for (int t = 0; t < TICKS; t++) {
+                const float* in = &inputs[t * CONTROLLERS];
+                const float* tg = &targets[t * CONTROLLERS];
+                for (int c = 0; c < CONTROLLERS; c++) {
+                    bank.target_set(c, tg[c]);
+                    bank.input_set(c, in[c]);
+                }
+                bank.compute();
+                double sum = 0;
+                for (int c = 0; c < CONTROLLERS; c++) sum += bank.output_get(c);
+                sink = sink + sum;
+            }
+        }
+        double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Output difference on one more pass, against the output's size
+        worst = 0;
+        for (int c = 0; c < CONTROLLERS; c++) bank.variables_reset(c);
+        for (int t = 0; t < TICKS; t++) {
+            for (int c = 0; c < CONTROLLERS; c++) {
+                bank.target_set(c, targets[t * CONTROLLERS + c]);
+                bank.input_set(c, inputs[t * CONTROLLERS + c]);
+            }
+            bank.compute();
+            for (int c = 0; c < CONTROLLERS; c++) {
+                double ref = reference[t * CONTROLLERS + c];
+                worst = std::fmax(worst, std::fabs(bank.output_get(c) - ref) / std::fmax(1, std::fabs(ref)));
+            }
+        }
+        return s;
+    };
+
+    double bank_worst = 0;
+    PidBank<20> bank;
+    double bank_s = run_bank(bank, bank_worst);
+
+    double n = (double)TICKS * REPEATS;
+    printf("%d controllers, %d ticks\n", CONTROLLERS, TICKS * REPEATS);
+    printf("ez::PID objects  %8.1f ns/tick  %zu bytes each\n", ez_s / n * 1e9, sizeof(EzPid));
+    printf("PidBank          %8.1f ns/tick  (%.1fx)  %zu bytes  worst output error %.4f%%\n", bank_s / n * 1e9,
+           ez_s / bank_s, sizeof(bank), bank_worst * 100);
+    return 0;
+}
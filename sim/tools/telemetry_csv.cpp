@@ -0,0 +1,45 @@
+#include <cstdio>
+
+#include "organiz/telemetry_format.h"
+
+// Turns a /usd/tlm_NNN.bin recording into CSV on stdout.
+//
+//   make telemetry_csv && ./bin/telemetry_csv tlm_000.bin > tlm_000.csv
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s tlm_NNN.bin\n", argv[0]);
+    return 2;
+  }
+
+  FILE* f = fopen(argv[1], "rb");
+  if (f == nullptr) {
+    perror(argv[1]);
+    return 1;
+  }
+
+  TelemetryHeader header;
+  if (fread(&header, sizeof(header), 1, f) != 1 || header.magic != TELEMETRY_MAGIC) {
+    fprintf(stderr, "%s: not a telemetry file\n", argv[1]);
+    return 1;
+  }
+  if (header.version != TELEMETRY_VERSION || header.sample_size != sizeof(TelemetrySample)) {
+    fprintf(stderr, "%s: version %u (%u byte samples), this decoder reads version %u\n", argv[1],
+            header.version, header.sample_size, TELEMETRY_VERSION);
+    return 1;
+  }
+
+  printf("time_ms,mode,interfered,target_left,target_right,target_heading,x,y,theta,"
+         "sensor_left,sensor_right,imu,mA_left,mA_right,out_left,out_right,out_turn,out_swing,out_heading\n");
+
+  TelemetrySample s;
+  while (fread(&s, sizeof(s), 1, f) == 1) {
+    printf("%u,%u,%u,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.0f,%.0f,%.2f,%.2f,%.2f,%.2f,%.2f\n",
+           s.time_ms, s.mode, (s.flags & TELEMETRY_INTERFERED) ? 1 : 0, s.target_left, s.target_right,
+           s.target_heading, s.x, s.y, s.theta, s.sensor_left, s.sensor_right, s.imu, s.mA_left, s.mA_right,
+           s.out_left, s.out_right, s.out_turn, s.out_swing, s.out_heading);
+  }
+
+  fclose(f);
+  return 0;
+}
@@ -14,6 +14,10 @@ const int SWING_SPEED = 90;
 // Constants
 ///
 void default_constants() {
+  // Effective track width, scrub included, for odom's wheel heading and the
+  // profiled turns. Measure it from a 10 turn spin: wheel travel / (10 * pi).
+  chassis.drive_width_set(12_in);
+
   chassis.pid_heading_constants_set(4, 0, 20);
   chassis.pid_drive_constants_forward_set(2, 0, 35);
   chassis.pid_drive_constants_backward_set(2.5, 0.007, 20, 1);
@@ -23,11 +27,26 @@ void default_constants() {
   chassis.pid_turn_exit_condition_set(300_ms, 3_deg, 500_ms, 7_deg, 750_ms, 750_ms);
   chassis.pid_swing_exit_condition_set(300_ms, 3_deg, 500_ms, 7_deg, 750_ms, 750_ms);
   chassis.pid_drive_exit_condition_set(300_ms, 1_in, 500_ms, 3_in, 750_ms, 750_ms);
+  settle_mode_set(SettleMode::PREDICT); // routines leave settled motions early, EZ's timers above as the backstop
 
   chassis.slew_drive_constants_set(7_in, 80);
   chassis.slew_turn_constants_set(5_deg, 50);
   chassis.slew_swing_constants_set(5_deg, 50);
 
+  chassis.pid_drive_chain_constant_set(3_in);
+  chassis.pid_turn_chain_constant_set(3_deg);
+  chassis.pid_swing_chain_constant_set(5_deg);
+
+  // {max in/s, in/s^2, in/s^3}, {kS, kV, kA, kP}. Not measured, so profiled
+  // steps run on pid_drive_set() until a characterization replaces the feedforward.
+  drive_profile_constants_set({60, 120, 600}, {0, 1.66, 0.2, 8});
+
+  // Lady brown, fitted to the sim's arm (./bin/sim --arm). Retune kG first
+  // if the real arm sags or creeps at a state.
+  lady_brown.constants_set({300, 1500, 0}, {30, 90, 4, 0.2, 0.012});
+  lady_brown.pid.constants_set(3, 0, 10);
+  lady_brown.pid.exit_condition_set(80, 2, 250, 6, 500, 500);
+
   
 }
 
@@ -36,68 +55,75 @@ void do_nothing() {
 }
 //first auton sketfch out
   
-void blue_ring_rush() {
-  chassis.drive_angle_set(90);
-  // doinker.set(true);
-  backClamp.set(false);
-
-  chassis.pid_drive_set(-10, DRIVE_SPEED);
-  chassis.pid_wait();
-
-  chassis.pid_swing_set(ez::LEFT_SWING, 0, SWING_SPEED);
-  chassis.pid_wait();
-
-  // doinker.set(false);
-  intake.move(120);
-  pros::delay(1000);
-  intake.brake();
-
-  chassis.pid_drive_set(10, DRIVE_SPEED);
-  chassis.pid_wait();
-
-  chassis.pid_swing_set(ez::LEFT_SWING, 45, SWING_SPEED);
-  chassis.pid_wait();
-
-  chassis.pid_drive_set(18, DRIVE_SPEED);
-  chassis.pid_wait();
-
-  chassis.pid_turn_set(-135, TURN_SPEED);
-  chassis.pid_wait();
-
-  chassis.pid_drive_set(-15, DRIVE_SPEED);
-  chassis.pid_wait();
-
-  backClamp.set(true);
-  pros::delay(200);
-
-  chassis.pid_turn_set(-260, TURN_SPEED);
-  chassis.pid_wait();
-
-  intake.move(100);
-  chassis.pid_drive_set(28, DRIVE_SPEED);
-  chassis.pid_wait();
-
-  chassis.pid_turn_set(-362, TURN_SPEED);
-  chassis.pid_wait();
-
-  intake.move(120);
-  chassis.pid_drive_set(24, DRIVE_SPEED);
-  chassis.pid_wait();
-
-  chassis.pid_drive_set(0,0);
-  pros::delay(500);
-
-  chassis.pid_drive_set(-5, DRIVE_SPEED);
-  chassis.pid_wait();
-
-  chassis.pid_turn_set(-431, TURN_SPEED);
-  chassis.pid_wait();
-
-  chassis.pid_drive_set(40, DRIVE_SPEED);
-  chassis.pid_wait();
-  intake.brake();
-
+// Red routines are mirror() of the blue ones, built at compile time.
+// They're timelines, so mechanisms run alongside the drive instead of
+// between motions, and each node says what it waits on. chain() blends
+// motions that follow each other straight away.
+constexpr auto blue_ring_rush_nodes = chain(std::array{
+  then(step_angle(90)),
+  then(step_color_sort(RingColor::RED)),
+  then(step_clamp(false)),
+  then(step_drive_profiled(-10, DRIVE_SPEED)),
+  then(step_swing(StepSide::LEFT, 0, SWING_SPEED)),
+
+  // Score the preload for a second, already pulling away
+  for_ms(then(step_intake(120)), 1000),
+  with(step_drive_profiled(10, DRIVE_SPEED)),
+  then(step_swing(StepSide::LEFT, 45, SWING_SPEED)),
+  then(step_drive_profiled(18, DRIVE_SPEED)),
+  then(step_turn(-135, TURN_SPEED)),
+  then(step_drive_profiled(-15, DRIVE_SPEED)),
+
+  // Clamp on the way in, turn once the drive is done
+  within(2, step_clamp(true)),
+  back_to(2, then(step_turn(-260, TURN_SPEED))),
+  with(step_intake(100)),
+  back_to(2, then(step_drive_profiled(28, DRIVE_SPEED))),
+  then(step_turn(-362, TURN_SPEED)),
+  with(step_intake(120)),
+  back_to(2, then(step_drive_profiled(24, DRIVE_SPEED))),
+
+  then(step_drive(0, 0)),
+  with(step_delay(500)),
+
+  then(step_drive_profiled(-5, DRIVE_SPEED)),
+  then(step_turn(-431, TURN_SPEED)),
+  then(step_drive_profiled(40, DRIVE_SPEED)),
+  then(step_intake_stop()),
+});
+constexpr auto red_ring_rush_nodes = mirror(blue_ring_rush_nodes);
+
+constexpr auto blue_goal_rush_nodes = chain(std::array{
+  then(step_angle(-30)),
+  then(step_color_sort(RingColor::RED)),
+  then(step_doinker(true)),
+  then(step_drive_profiled(190, DRIVE_SPEED, true)),
+  then(step_turn(-10, TURN_SPEED)),
+  then(step_doinker(false)),
+  then(step_drive_profiled(-10, DRIVE_SPEED, true)),
+
+  then(step_turn(-180, TURN_SPEED)),
+  with(step_doinker(true)),
+  back_to(2, then(step_turn(-90, TURN_SPEED))),
+  with(step_doinker(false)),
+
+  back_to(2, then(step_drive_profiled(-10, DRIVE_SPEED))),
+  within(2, step_clamp(true)),
+  with(step_intake(100)),
+  back_to(3, then(step_drive(0, 0))),
+  then(step_delay(2000)),
+  then(step_intake_stop()),
+});
+constexpr auto red_goal_rush_nodes = mirror(blue_goal_rush_nodes);
+
+static_assert(timeline_valid(blue_ring_rush_nodes));
+static_assert(timeline_valid(blue_goal_rush_nodes));
+// Mirroring twice has to give back the original, otherwise mirror() lost something
+static_assert(mirror(red_ring_rush_nodes) == blue_ring_rush_nodes);
+static_assert(mirror(red_goal_rush_nodes) == blue_goal_rush_nodes);
 
+void blue_ring_rush() {
+  timeline_run(blue_ring_rush_nodes);
 
   // chassis.pid_drive_set(-36_in, 100, true);
   // chassis.pid_wait();
@@ -128,38 +154,8 @@ void blue_ring_rush() {
 //second auton sketfch out
 
 void blue_goal_rush() {
-  chassis.drive_angle_set(-30);
-  doinker.set(true);
-
-  chassis.pid_drive_set(190, DRIVE_SPEED, true);
-  chassis.pid_wait();
-  
-  chassis.pid_turn_set(-10, TURN_SPEED);
-  chassis.pid_wait();
-  doinker.set(false);
-
-  chassis.pid_drive_set(-10, DRIVE_SPEED, true);
-  chassis.pid_wait();
-
-  chassis.pid_turn_set(-180, TURN_SPEED);
-  doinker.set(true);
-  chassis.pid_wait();
-
-  chassis.pid_turn_set(-90, TURN_SPEED);
-  doinker.set(false);
-  chassis.pid_wait();
+  timeline_run(blue_goal_rush_nodes);
 
-  chassis.pid_drive_set(-10, DRIVE_SPEED);
-  chassis.pid_wait();
-
-  backClamp.set(true);
-  intake.move(100);
-
-  chassis.pid_drive_set(0,0);
-  chassis.pid_wait();
-
-  pros::delay(2000);
-  intake.brake();
   // chassis.drive_angle_set(-90);
   // // doinker.set(true);
   // backClamp.set(false);
@@ -243,117 +239,28 @@ void blue_goal_rush() {
 }
 
 void red_ring_rush() {
-    chassis.drive_angle_set(-90);
-  // doinker.set(true);
-  backClamp.set(false);
-
-  chassis.pid_drive_set(-10, DRIVE_SPEED);
-  chassis.pid_wait();
-
-  chassis.pid_swing_set(ez::RIGHT_SWING, 0, SWING_SPEED);
-  chassis.pid_wait();
-
-  // doinker.set(false);
-  intake.move(120);
-  pros::delay(1000);
-  intake.brake();
-
-  chassis.pid_drive_set(10, DRIVE_SPEED);
-  chassis.pid_wait();
-
-  chassis.pid_swing_set(ez::RIGHT_SWING, -45, SWING_SPEED);
-  chassis.pid_wait();
-
-  chassis.pid_drive_set(18, DRIVE_SPEED);
-  chassis.pid_wait();
-
-  chassis.pid_turn_set(135, TURN_SPEED);
-  chassis.pid_wait();
-
-  chassis.pid_drive_set(-15, DRIVE_SPEED);
-  chassis.pid_wait();
-
-  backClamp.set(true);
-  pros::delay(200);
-
-  chassis.pid_turn_set(260, TURN_SPEED);
-  chassis.pid_wait();
-
-  intake.move(100);
-  chassis.pid_drive_set(28, DRIVE_SPEED);
-  chassis.pid_wait();
-
-  chassis.pid_turn_set(362, TURN_SPEED);
-  chassis.pid_wait();
-
-  intake.move(120);
-  chassis.pid_drive_set(24, DRIVE_SPEED);
-  chassis.pid_wait();
-
-  chassis.pid_drive_set(0,0);
-  pros::delay(500);
-
-  chassis.pid_drive_set(-5, DRIVE_SPEED);
-  chassis.pid_wait();
-
-  chassis.pid_turn_set(431, TURN_SPEED);
-  chassis.pid_wait();
-
-  chassis.pid_drive_set(40, DRIVE_SPEED);
-  chassis.pid_wait();
-  intake.brake();
+  timeline_run(red_ring_rush_nodes);
 }
-void red_goal_rush() {
-    chassis.drive_angle_set(30);
-  doinker.set(true);
-
-  chassis.pid_drive_set(190, DRIVE_SPEED, true);
-  chassis.pid_wait();
-  
-  chassis.pid_turn_set(10, TURN_SPEED);
-  chassis.pid_wait();
-  doinker.set(false);
-
-  chassis.pid_drive_set(-10, DRIVE_SPEED, true);
-  chassis.pid_wait();
-
-  chassis.pid_turn_set(180, TURN_SPEED);
-  doinker.set(true);
-  chassis.pid_wait();
-
-  chassis.pid_turn_set(90, TURN_SPEED);
-  doinker.set(false);
-  chassis.pid_wait();
 
-  chassis.pid_drive_set(-10, DRIVE_SPEED);
-  chassis.pid_wait();
-
-  backClamp.set(true);
-  intake.move(100);
-
-  chassis.pid_drive_set(0,0);
-  chassis.pid_wait();
-
-  pros::delay(2000);
-  intake.brake();
+void red_goal_rush() {
+  timeline_run(red_goal_rush_nodes);
 }
 
-
 void skills_code() {
   chassis.drive_angle_set(0);
   backClamp.set(false);
   
-  intake.move(100);
+  intake_set(100);
   pros::delay(1000);
 
   chassis.pid_drive_set(10, DRIVE_SPEED);
-  chassis.pid_wait();
+  pid_wait_settle();
 
   chassis.pid_turn_set(90, TURN_SPEED);
-  chassis.pid_wait();
+  pid_wait_settle();
 
   chassis.pid_drive_set(-10, DRIVE_SPEED);
-  chassis.pid_wait();
+  pid_wait_settle();
 
   
   
@@ -540,4 +447,28 @@ void interfered_example() {
 
 // . . .
 // Make your own autonomous functions here!
-// . . .
\ No newline at end of file
+// . . .
+///
+// Registry
+///
+// Every auton the selector and the sim know about, in selector order.
+// Times are `./bin/sim`'s, so a change that slows an auton shows up there.
+constexpr AutonInfo auton_table[] = {
+  {"BLUE RING SIDE CODE", blue_ring_rush, Alliance::BLUE, AutonSide::RING, 18770},
+  {"BLUE GOAL SIDE CODE", blue_goal_rush, Alliance::BLUE, AutonSide::GOAL, 11380},
+  {"RED RING SIDE CODE", red_ring_rush, Alliance::RED, AutonSide::RING, 18770},
+  {"RED GOAL SIDE CODE", red_goal_rush, Alliance::RED, AutonSide::GOAL, 11380},
+  {"SKILLS CODE", skills_code, Alliance::NONE, AutonSide::SKILLS, 4650},
+  {"Example Drive", drive_example, Alliance::NONE, AutonSide::NONE, 8740, "Drive forward and come back."},
+  {"Example Turn", turn_example, Alliance::NONE, AutonSide::NONE, 1910, "Turn 3 times."},
+  {"Drive and Turn", drive_and_turn, Alliance::NONE, AutonSide::NONE, 6280, "Drive forward, turn, come back."},
+  {"Wait Until Change Speed", wait_until_change_speed, Alliance::NONE, AutonSide::NONE, 6310, "Slow down during drive."},
+  {"Swing Example", swing_example, Alliance::NONE, AutonSide::NONE, 2880, "Swing in an 'S' curve"},
+  {"Combine all 3 movements", combining_movements, Alliance::NONE, AutonSide::NONE, 6150},
+  {"Interference", interfered_example, Alliance::NONE, AutonSide::NONE, 3950,
+   "After driving forward, robot\nperforms differently if\ninterfered or not."},
+  {"DO NOTHING", do_nothing, Alliance::NONE, AutonSide::NONE, 0, "THIS CODE STAYS STILL\nAND DOES NOTHING"},
+};
+static_assert(auton_registry_valid(auton_table));
+
+constinit const std::span<const AutonInfo> auton_registry = auton_table;
@@ -25,14 +25,9 @@ void on_center_button() {
 void initialize() {
 	pros::lcd::initialize();
 	// pros::lcd::register_btn1_cb([]{sunaiControls != sunaiControls});
-  pros::Task lb_control_task([]{
-    while (true)
-    {
-      lb_liftControl();
-      pros::delay(ez::util::DELAY_TIME);
-    }
-    
-  });
+  lb_loop.start();
+  color_sort_start();
+  ui_start(); // Queued LCD and controller writes
 
   // Print our branding over your terminal :D
   ez::ez_template_print();
@@ -43,35 +38,28 @@ void initialize() {
   chassis.opcontrol_drive_activebrake_set(0); // Sets the active brake kP. We recommend 2.
   chassis.opcontrol_curve_default_set(0, 0); // Defaults for curve. If using tank, only the first parameter is used. (Comment this line out if you have an SD card!)  
   default_constants(); // Set the drive to your own constants from autons.cpp!
+  config_defaults_mark(); // A saved config from other defaults won't load over these
     
   // These are already defaulted to these buttons, but you can change the left/right curve buttons here!
   // chassis.opcontrol_curve_buttons_left_set (pros::E_CONTROLLER_DIGITAL_LEFT, pros::E_CONTROLLER_DIGITAL_RIGHT); // If using tank, only the left side is used. 
   // chassis.opcontrol_curve_buttons_right_set(pros::E_CONTROLLER_DIGITAL_Y,    pros::E_CONTROLLER_DIGITAL_A);
     
-  // Autonomous Selector using LLEMU
-  ez::as::auton_selector.autons_add({
-    
-    Auton("BLUE RING SIDE CODE", blue_ring_rush),
-    Auton("BLUE GOAL SIDE CODE", blue_goal_rush),
-    Auton("RED RING SIDE CODE", red_ring_rush),
-    Auton("RED GOAL SIDE CODE", red_goal_rush),
-    Auton("SKILLS CODE", skills_code),
-    Auton("Example Drive\n\nDrive forward and come back.", drive_example),
-    Auton("Example Turn\n\nTurn 3 times.", turn_example),
-    Auton("Drive and Turn\n\nDrive forward, turn, come back. ", drive_and_turn),
-    Auton("Drive and Turn\n\nSlow down during drive.", wait_until_change_speed),
-    Auton("Swing Example\n\nSwing in an 'S' curve", swing_example),
-    Auton("Combine all 3 movements", combining_movements),
-    Auton("Interference\n\nAfter driving forward, robot performs differently if interfered or not.", interfered_example),
-    Auton("DO NOTHING \n THIS CODE STAYS STILL AND DOES NOTHING", do_nothing),
-  });
-    
   // Initialize chassis and auton selector
   ladyBrownSensor.reset();
   chassis.initialize();
-  ez::as::initialize();
+  auton_select_init(); // LLEMU left and right pick from the auton registry in src/autons.cpp
+  odom_start();
+
+  // Constants saved from the PID tuner, over default_constants(). See include/organiz/config.h
+  if (ez::util::SD_CARD_ACTIVE) config_load(CONFIG_PATH);
+  // Drive profiles planned on a computer, see include/organiz/motion_profile.h
+  if (ez::util::SD_CARD_ACTIVE) profile_pack_load("/usd/profiles.bin");
+  // Feedforward from the last drive characterization, see include/organiz/characterize.h
+  if (ez::util::SD_CARD_ACTIVE) drive_feedforward_load("/usd/feedforward.txt");
+  // The auton's recording file, so autonomous() doesn't wait on the card
+  telemetry_open();
   // pros::lcd::set_background_color(LV_COLOR_HEX(0xFFC0CB));
-  master.rumble(".");
+  controller_rumble("."); // Ready, through the ui queue
 }
 
 /**
@@ -79,7 +67,9 @@ void initialize() {
  * the VEX Competition Switch, following either autonomous or opcontrol. When
  * the robot is enabled, this task will exit.
  */
-void disabled() {}
+void disabled() {
+  telemetry_stop();
+}
 
 /**
  * Runs after initialize(), and before autonomous when connected to the Field
@@ -108,8 +98,11 @@ void autonomous() {
   chassis.drive_imu_reset(); // Reset gyro position to 0
   chassis.drive_sensor_reset(); // Reset drive sensors to 0
   chassis.drive_brake_set(MOTOR_BRAKE_HOLD); // Set motors to hold.  This helps autonomous consistency
+  odom_reset(0, 0); // Our 5 ms odom starts from here too
+  telemetry_start(); // Record what the chassis sees to the SD card
+  settle_stats_reset(); // Per-motion settle times for this run
 
-  ez::as::auton_selector.selected_auton_call(); // Calls selected auton from autonomous selector
+  auton_selected_run(); // Calls the auton picked on the brain
 }
 
 /**
@@ -126,46 +119,94 @@ void autonomous() {
  * task, not resume it from where it left off.
  */
 
+LoopTimer opcontrol_timer("opcontrol", ez::util::DELAY_TIME);
+
 void opcontrol() {
 
+    telemetry_stop(); // Write out the auton recording
+
     // This is preference to what you like to drive on
     chassis.drive_brake_set(MOTOR_BRAKE_COAST);
+    color_sort_alliance_set(auton_selected().alliance); // Not whatever the auton left set
     bool sunaiControls = false;
+    uint32_t save_offer_until = 0; // B saves the config until then
+    opcontrol_timer.stats_reset();
   
   
     while (true) {
-      pros::lcd::print(4, "%d %d %d", (pros::lcd::read_buttons() & LCD_BTN_LEFT) >> 2,
-      (pros::lcd::read_buttons() & LCD_BTN_CENTER) >> 1,
-      (pros::lcd::read_buttons() & LCD_BTN_RIGHT) >> 0);  // Prints status of the emulated screen LCDs
+      const ControllerState& pad = controller_poll(); // Every button and stick, read once this tick
+
+      lcd_text_set(4, "%d %d %d", (pad.lcd_buttons & LCD_BTN_LEFT) >> 2,
+      (pad.lcd_buttons & LCD_BTN_CENTER) >> 1,
+      (pad.lcd_buttons & LCD_BTN_RIGHT) >> 0);  // Prints status of the emulated screen LCDs
 
       // PID Tuner
-      // After you find values that you're happy with, you'll have to set them in auton.cpp
+      // Values you're happy with stay on the SD card, set them in auton.cpp to keep them without it
       if (!pros::competition::is_connected()) { 
         // Enable / Disable PID Tuner
         //  When enabled: 
         //  * use A and Y to increment / decrement the constants
         //  * use the arrow keys to navigate the constants
-        if (master.get_digital_new_press(DIGITAL_X)) 
+        //  Closing it offers to save every constant to the SD card for the
+        //  next boot, B within 5 s does
+        if (pad.new_press(DIGITAL_X)) {
+          field_view_show(false); // The tuner draws on the LLEMU screen
           chassis.pid_tuner_toggle();
+          save_offer_until = 0;
+          if (!chassis.pid_tuner_enabled()) {
+            lcd_redraw(); // The tuner drew over the auton pick
+            if (ez::util::SD_CARD_ACTIVE) {
+              save_offer_until = pros::millis() + 5000;
+              controller_text_set(1, "B: save config");
+            }
+          }
+        }
+        if (save_offer_until != 0 && pros::millis() >= save_offer_until) {
+          save_offer_until = 0;
+          controller_text_set(1, "config not saved");
+        }
           
+        // Live field on the brain screen, Y again for LLEMU back
+        if (pad.new_press(DIGITAL_Y) && !chassis.pid_tuner_enabled())
+          field_view_show(!field_view_shown());
+
         // Trigger the selected autonomous routine
-        if (master.get_digital_new_press(DIGITAL_DOWN)) 
+        if (pad.new_press(DIGITAL_DOWN)) 
           autonomous();
   
         chassis.pid_tuner_iterate(); // Allow PID Tuner to iterate
+
+        // Save the config if it was just offered, otherwise print loop
+        // timing stats to the terminal. With the tuner open,
+        // characterize the drive instead, or autotune the PIDs with L1 held.
+        if (pad.new_press(DIGITAL_B)) {
+          if (save_offer_until != 0) {
+            save_offer_until = 0;
+            controller_text_set(1, config_save(CONFIG_PATH) ? "config saved" : "config not saved");
+          }
+          else if (!chassis.pid_tuner_enabled()) {
+            loop_stats_print();
+            settle_stats_print();
+          }
+          else if (pad.down(DIGITAL_L1))
+            pid_autotune_all();
+          else
+            drive_characterize();
+        }
       } 
   
-      doinker.button_toggle(master.get_digital_new_press(DIGITAL_A));
+      doinker.button_toggle(pad.new_press(DIGITAL_A));
       // backClamp.button_toggle(master.get_digital_new_press(DIGITAL_L2));
-      intakePiston.button_toggle(master.get_digital_new_press(DIGITAL_LEFT));
+      intakePiston.button_toggle(pad.new_press(DIGITAL_LEFT));
   
   
-      if (master.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_RIGHT)) {
+      if (pad.new_press(pros::E_CONTROLLER_DIGITAL_RIGHT)) {
         if (sunaiControls) {
           sunaiControls = false;
         } else {
           sunaiControls = true;
         }
+        controller_text_set(0, sunaiControls ? "single arcade" : "split arcade");
       }
   
       if (sunaiControls) {
@@ -181,24 +222,24 @@ void opcontrol() {
       // chassis.opcontrol_arcade_flipped(ez::SPLIT); // Flipped split arcade
       // chassis.opcontrol_arcade_flipped(ez::SINGLE); // Flipped single arcade
   
-      if (master.get_digital(pros::E_CONTROLLER_DIGITAL_R2)) {
-        intake.move(127);
-      } else if (master.get_digital(pros::E_CONTROLLER_DIGITAL_R1)) {
-        intake.move(-127);
+      if (pad.down(pros::E_CONTROLLER_DIGITAL_R2)) {
+        intake_set(127);
+      } else if (pad.down(pros::E_CONTROLLER_DIGITAL_R1)) {
+        intake_set(-127);
       } else {
-        intake.brake();
+        intake_set(0);
       }
   
-      if (master.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_L2)) {
+      if (pad.new_press(pros::E_CONTROLLER_DIGITAL_L2)) {
         backClamp.set(true);
-      } else if (master.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_L1)) {
+      } else if (pad.new_press(pros::E_CONTROLLER_DIGITAL_L1)) {
         backClamp.set(false);
       }
   
-      if (master.get_digital_new_press(DIGITAL_UP)) {
+      if (pad.new_press(DIGITAL_UP)) {
         lb_nextState();
       }
   
-      pros::delay(ez::util::DELAY_TIME); // This is used for timer calculations!  Keep this ez::util::DELAY_TIME
+      opcontrol_timer.wait(); // Fixed ez::util::DELAY_TIME period, used for timer calculations!
     }
 }
\ No newline at end of file
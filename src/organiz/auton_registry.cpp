@@ -0,0 +1,43 @@
+#include "organiz/auton_registry.h"
+
+const char* alliance_name(Alliance alliance) {
+    switch (alliance) {
+        case Alliance::RED:
+            return "red";
+        case Alliance::BLUE:
+            return "blue";
+        default:
+            return "";
+    }
+}
+
+const char* auton_side_name(AutonSide side) {
+    switch (side) {
+        case AutonSide::RING:
+            return "ring side";
+        case AutonSide::GOAL:
+            return "goal side";
+        case AutonSide::SKILLS:
+            return "skills";
+        default:
+            return "";
+    }
+}
+
+int auton_find(const char* name) {
+    for (size_t i = 0; i < auton_registry.size(); i++) {
+        if (name_equal(auton_registry[i].name, name)) return i;
+    }
+    return -1;
+}
+
+int auton_mirror(int index) {
+    if (index < 0 || index >= (int)auton_registry.size()) return -1;
+    const AutonInfo& a = auton_registry[index];
+    if (a.alliance == Alliance::NONE) return -1;
+    for (size_t i = 0; i < auton_registry.size(); i++) {
+        const AutonInfo& b = auton_registry[i];
+        if (b.side == a.side && b.alliance != Alliance::NONE && b.alliance != a.alliance) return i;
+    }
+    return -1;
+}
@@ -0,0 +1,71 @@
+#include <atomic>
+#include <cstring>
+
+#include "main.h"
+#include "organiz/auton_select.h"
+
+static std::atomic<int> selected{0};
+
+static void show() {
+    const AutonInfo& a = auton_selected();
+    lcd_text_set(0, "%s", a.name);
+
+    // Three description lines, a line per '\n'
+    const char* d = a.description;
+    for (int line = 1; line <= 3; line++) {
+        const char* end = strchr(d, '\n');
+        int len = end != nullptr ? end - d : strlen(d);
+        lcd_text_set(line, "%.*s", len, d);
+        d += end != nullptr ? len + 1 : len;
+    }
+
+    // Line 4 is opcontrol's
+    if (a.expected_ms > 0) {
+        lcd_text_set(5, "%d/%d %s %s %.1fs", selected + 1, (int)auton_registry.size(), alliance_name(a.alliance),
+                     auton_side_name(a.side), a.expected_ms / 1000.0);
+    } else {
+        lcd_text_set(5, "%d/%d %s %s", selected + 1, (int)auton_registry.size(), alliance_name(a.alliance),
+                     auton_side_name(a.side));
+    }
+}
+
+static void save() {
+    if (!ez::util::SD_CARD_ACTIVE) return;
+    FILE* f = fopen(AUTON_SELECT_PATH, "w");
+    if (f == nullptr) return;
+    fprintf(f, "%s\n", auton_selected().name);
+    fclose(f);
+}
+
+static void load() {
+    if (!ez::util::SD_CARD_ACTIVE) return;
+    FILE* f = fopen(AUTON_SELECT_PATH, "r");
+    if (f == nullptr) return;
+    char name[64] = "";
+    if (fgets(name, sizeof(name), f) != nullptr) {
+        name[strcspn(name, "\n")] = '\0';
+        int index = auton_find(name);
+        if (index >= 0) selected = index;
+    }
+    fclose(f);
+}
+
+void auton_select(int index) {
+    int count = auton_registry.size();
+    selected = ((index % count) + count) % count;
+    show();
+    save();
+}
+
+int auton_selected_index() { return selected; }
+
+const AutonInfo& auton_selected() { return auton_registry[selected]; }
+
+void auton_selected_run() { auton_selected().fn(); }
+
+void auton_select_init() {
+    load();
+    show();
+    pros::lcd::register_btn0_cb([] { auton_select(selected - 1); });
+    pros::lcd::register_btn2_cb([] { auton_select(selected + 1); });
+}
@@ -0,0 +1,148 @@
+#include "main.h"
+#include "organiz/autotune.h"
+
+// Relay size (out of 127), hysteresis and the test move, in or deg
+struct LoopSetup {
+    const char* name;
+    double relay;
+    double hysteresis;
+    double move;
+};
+static const LoopSetup setups[] = {
+    {"turn", 50, 0.5, 90},
+    {"drive", 40, 0.1, 24},
+    {"swing", 60, 0.5, 45},
+};
+
+static const uint32_t RELAY_TIMEOUT = 8000; // ms
+static const int MOVE_SPEED = 110;
+static LoopTimer timer("autotune", ez::util::DELAY_TIME);
+
+// The gains being tuned, and the PID EZ checks the exit conditions on
+static ez::PID& tuned_pid(TuneLoop loop) {
+    if (loop == TuneLoop::TURN) return chassis.turnPID;
+    if (loop == TuneLoop::DRIVE) return chassis.forward_drivePID;
+    return chassis.forward_swingPID;
+}
+
+static ez::PID& exit_pid(TuneLoop loop) {
+    if (loop == TuneLoop::TURN) return chassis.turnPID;
+    if (loop == TuneLoop::DRIVE) return chassis.leftPID;
+    return chassis.swingPID;
+}
+
+const char* tune_loop_name(TuneLoop loop) {
+    return setups[(int)loop].name;
+}
+
+const char* pid_autotune_unready() {
+    if (chassis.drive_width_get() <= 0) return "no drive width";
+    for (TuneLoop loop : {TuneLoop::TURN, TuneLoop::DRIVE, TuneLoop::SWING}) {
+        const ez::PID& pid = exit_pid(loop);
+        if (pid.exit.small_error <= 0 || pid.exit.small_exit_time <= 0) return "exit conditions not set";
+    }
+    return nullptr;
+}
+
+static void constants_set(TuneLoop loop, const ez::PID::Constants& c) {
+    if (loop == TuneLoop::TURN) {
+        chassis.pid_turn_constants_set(c.kp, c.ki, c.kd, c.start_i);
+    } else if (loop == TuneLoop::DRIVE) {
+        chassis.pid_drive_constants_forward_set(c.kp, c.ki, c.kd, c.start_i);
+    } else {
+        chassis.pid_swing_constants_forward_set(c.kp, c.ki, c.kd, c.start_i);
+    }
+}
+
+// in for drives, deg for turns and swings
+static double measure(TuneLoop loop) {
+    if (loop == TuneLoop::DRIVE) return (chassis.drive_sensor_left() + chassis.drive_sensor_right()) / 2;
+    return chassis.drive_imu_get();
+}
+
+static RelayResult relay_run(TuneLoop loop) {
+    const LoopSetup& s = setups[(int)loop];
+    RelayExperiment relay(s.relay, s.hysteresis);
+    double target = measure(loop);
+
+    chassis.drive_mode_set(ez::DISABLE, false);
+    uint32_t start = pros::millis();
+    timer.stats_reset();
+    while (!relay.done() && pros::millis() - start < RELAY_TIMEOUT) {
+        double out = relay.update(target - measure(loop), (pros::millis() - start) / 1000.0);
+        if (loop == TuneLoop::TURN) {
+            drive_io.set(out, -out);
+        } else if (loop == TuneLoop::DRIVE) {
+            drive_io.set(out, out);
+        } else {
+            drive_io.set(out, 0); // left swing, the right side holds
+        }
+        timer.wait();
+    }
+    drive_io.set(0, 0);
+    pros::delay(500);
+    return relay.result();
+}
+
+// Out and back, only the way out is timed since that's the gains being tuned
+static TuneCandidate move_try(TuneLoop loop, const char* name, const ez::PID::Constants& c) {
+    const LoopSetup& s = setups[(int)loop];
+    constants_set(loop, c);
+    double start = measure(loop);
+
+    uint32_t t0 = pros::millis();
+    if (loop == TuneLoop::TURN) {
+        chassis.pid_turn_set(start + s.move, MOVE_SPEED);
+    } else if (loop == TuneLoop::DRIVE) {
+        chassis.pid_drive_set(s.move, MOVE_SPEED);
+    } else {
+        chassis.pid_swing_set(ez::LEFT_SWING, start + s.move, MOVE_SPEED);
+    }
+    chassis.pid_wait();
+    uint32_t ms = pros::millis() - t0;
+    double error = start + s.move - measure(loop);
+
+    if (loop == TuneLoop::TURN) {
+        chassis.pid_turn_set(start, MOVE_SPEED);
+    } else if (loop == TuneLoop::DRIVE) {
+        chassis.pid_drive_set(-s.move, MOVE_SPEED);
+    } else {
+        chassis.pid_swing_set(ez::LEFT_SWING, start, MOVE_SPEED);
+    }
+    chassis.pid_wait();
+
+    return {name, c, ms, error, std::fabs(error) <= exit_pid(loop).exit.small_error};
+}
+
+void pid_autotune_apply(TuneLoop loop, const ez::PID::Constants& constants) {
+    constants_set(loop, constants);
+}
+
+AutotuneResult pid_autotune(TuneLoop loop) {
+    AutotuneResult out = {};
+    if (pid_autotune_unready() != nullptr) return out;
+    ez::PID::Constants current = tuned_pid(loop).constants;
+    out.candidates[0] = move_try(loop, "current", current);
+    out.relay = relay_run(loop);
+    if (!out.relay.ok) {
+        constants_set(loop, current);
+        return out;
+    }
+
+    const TuneRule rules[] = {TuneRule::CLASSIC, TuneRule::SOME_OVERSHOOT, TuneRule::NO_OVERSHOOT};
+    for (int i = 0; i < 3; i++) {
+        TunedGains g = relay_gains(out.relay, rules[i], ez::util::DELAY_TIME / 1000.0);
+        // Only loops that already use an integral get one, inside the same start_i
+        ez::PID::Constants c = {g.kp, current.ki != 0 ? g.ki : 0, g.kd, current.start_i};
+        out.candidates[i + 1] = move_try(loop, tune_rule_name(rules[i]), c);
+    }
+
+    // Fastest candidate that settled, the current gains win ties
+    for (int i = 1; i < AUTOTUNE_CANDIDATES; i++) {
+        const TuneCandidate& c = out.candidates[i];
+        const TuneCandidate& best = out.candidates[out.chosen];
+        if (c.settled && (!best.settled || c.ms < best.ms)) out.chosen = i;
+    }
+    constants_set(loop, current);
+    return out;
+}
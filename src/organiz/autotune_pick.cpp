@@ -0,0 +1,59 @@
+#include "main.h"
+#include "organiz/autotune.h"
+
+// One loop's candidates on the LLEMU screen, where the tuner draws. LEFT and
+// RIGHT flip through them starting from the suggestion, A sets the one
+// shown and B keeps the current gains.
+static void pick(TuneLoop loop, const AutotuneResult& r) {
+    int shown = r.chosen;
+    while (true) {
+        const TuneCandidate& c = r.candidates[shown];
+        lcd_text_set(0, "%s autotune %d/%d%s", tune_loop_name(loop), shown + 1, AUTOTUNE_CANDIDATES,
+                     shown == r.chosen ? " (fastest)" : "");
+        lcd_text_set(1, "%s", c.name);
+        lcd_text_set(2, "p %.3f  i %.4f  d %.3f", c.constants.kp, c.constants.ki, c.constants.kd);
+        lcd_text_set(3, "%lums  error %.2f%s", (unsigned long)c.ms, c.error, c.settled ? "" : "  no settle");
+        // Line 4 is opcontrol's
+        lcd_text_set(5, "< > flip  A set  B keep");
+        controller_text_set(0, "%s %d/%d", tune_loop_name(loop), shown + 1, AUTOTUNE_CANDIDATES);
+
+        pros::delay(ez::util::DELAY_TIME);
+        const ControllerState& pad = controller_poll();
+        if (pad.new_press(DIGITAL_LEFT)) {
+            shown = (shown + AUTOTUNE_CANDIDATES - 1) % AUTOTUNE_CANDIDATES;
+        } else if (pad.new_press(DIGITAL_RIGHT)) {
+            shown = (shown + 1) % AUTOTUNE_CANDIDATES;
+        } else if (pad.new_press(DIGITAL_A)) {
+            pid_autotune_apply(loop, c.constants);
+            controller_text_set(0, "%s set", tune_loop_name(loop));
+            return;
+        } else if (pad.new_press(DIGITAL_B)) {
+            controller_text_set(0, "%s kept", tune_loop_name(loop));
+            return;
+        }
+    }
+}
+
+void pid_autotune_all() {
+    const char* unready = pid_autotune_unready();
+    if (unready != nullptr) {
+        controller_text_set(0, "%s", unready);
+        return;
+    }
+
+    // The tuner draws over the picker, it's back with the picks after
+    bool tuner = chassis.pid_tuner_enabled();
+    if (tuner) chassis.pid_tuner_disable();
+
+    for (TuneLoop loop : {TuneLoop::TURN, TuneLoop::DRIVE, TuneLoop::SWING}) {
+        AutotuneResult r = pid_autotune(loop);
+        if (!r.relay.ok) {
+            controller_text_set(0, "%s: no oscillation", tune_loop_name(loop));
+            continue;
+        }
+        pick(loop, r);
+    }
+
+    auton_select(auton_selected_index()); // the picker's lines were the auton's
+    if (tuner) chassis.pid_tuner_enable();
+}
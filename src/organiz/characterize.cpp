@@ -0,0 +1,130 @@
+#include "main.h"
+#include "organiz/characterize.h"
+#include "organiz/profiled_drive.h"
+
+static CharacterizeSample samples[CHARACTERIZE_SAMPLES_MAX];
+static int sample_count = 0;
+static LoopTimer timer("characterize", ODOM_PERIOD);
+
+// One test, each way. A ramp is quasistatic, a step is dynamic.
+static void run_test(double direction, bool step) {
+    DriveSnapshot snap;
+    DriveHealth health;
+    drive_io.read(snap);
+    double l_start = snap.left;
+    double r_start = snap.right;
+    uint32_t start = snap.time;
+
+    timer.stats_reset();
+    while (true) {
+        drive_io.read(snap);
+        double t = (snap.time - start) / 1000.0;
+        double traveled = std::fabs((snap.left - l_start) + (snap.right - r_start)) / 2;
+        if (traveled >= CHARACTERIZE_DISTANCE || snap.time - start >= CHARACTERIZE_TIME) break;
+
+        double out = direction * (step ? CHARACTERIZE_STEP : CHARACTERIZE_RAMP * t);
+        drive_io.set(out, out);
+        if (sample_count < CHARACTERIZE_SAMPLES_MAX) {
+            drive_io.health_read(health);
+            samples[sample_count++] = {snap.time, (float)(health.left_voltage * 127 / 12000),
+                                       (float)(health.right_voltage * 127 / 12000), (float)snap.left, (float)snap.right};
+        }
+        timer.wait();
+    }
+    drive_io.set(0, 0);
+    pros::delay(1000); // stopped before the next one
+}
+
+// Puts EZ back how it was, holding a motion where the robot is now instead
+// of driving back to the old target
+static void chassis_restore(ez::e_mode mode, pros::motor_brake_mode_e_t brake) {
+    chassis.drive_brake_set(brake);
+    if (mode == ez::DRIVE) {
+        chassis.leftPID.target_set(chassis.drive_sensor_left());
+        chassis.rightPID.target_set(chassis.drive_sensor_right());
+    }
+    if (mode == ez::TURN || mode == ez::SWING) {
+        chassis.turnPID.target_set(chassis.drive_imu_get());
+        chassis.swingPID.target_set(chassis.drive_imu_get());
+    }
+    if (mode == ez::DRIVE || mode == ez::TURN || mode == ez::SWING) chassis.headingPID.target_set(chassis.drive_imu_get());
+    chassis.drive_mode_set(mode);
+}
+
+DriveCharacterization drive_characterize_run(const char* log_path) {
+    ez::e_mode mode = chassis.drive_mode_get();
+    pros::motor_brake_mode_e_t brake = chassis.drive_brake_get();
+    chassis.drive_mode_set(ez::DISABLE, false);
+    sample_count = 0;
+    run_test(1, false);
+    run_test(-1, false);
+    run_test(1, true);
+    run_test(-1, true);
+    chassis_restore(mode, brake);
+
+    DriveCharacterization out;
+    feedforward_fit_log(samples, sample_count, out.left, out.right);
+    if (out.left.samples > 0 && out.right.samples > 0) drive_feedforward_apply(out.left.ff, out.right.ff);
+
+    if (log_path != nullptr) {
+        FILE* f = fopen(log_path, "wb");
+        if (f != nullptr) {
+            CharacterizeHeader header = {CHARACTERIZE_MAGIC, CHARACTERIZE_VERSION, sizeof(CharacterizeSample)};
+            fwrite(&header, sizeof(header), 1, f);
+            fwrite(samples, sizeof(CharacterizeSample), sample_count, f);
+            fclose(f);
+        }
+    }
+    return out;
+}
+
+void drive_characterize() {
+    char name[24] = "";
+    if (ez::util::SD_CARD_ACTIVE) {
+        // Next free char_NNN.bin, no log once all 1000 are taken
+        bool found = false;
+        for (int i = 0; i < 1000 && !found; i++) {
+            snprintf(name, sizeof(name), "/usd/char_%03d.bin", i);
+            FILE* existing = fopen(name, "r");
+            found = existing == nullptr;
+            if (existing != nullptr) fclose(existing);
+        }
+        if (!found) {
+            name[0] = '\0';
+            printf("characterize: char_000 to char_999 are taken, not logging this run\n");
+        }
+    }
+
+    DriveCharacterization fit = drive_characterize_run(name[0] ? name : nullptr);
+    for (const FeedforwardFit* side : {&fit.left, &fit.right}) {
+        printf("%-5s kS %6.3f  kV %6.4f  kA %6.4f  r2 %5.3f  %d samples\n", side == &fit.left ? "left" : "right",
+               side->ff.kS, side->ff.kV, side->ff.kA, side->r2, side->samples);
+    }
+    if (ez::util::SD_CARD_ACTIVE && fit.left.samples > 0 && fit.right.samples > 0) {
+        drive_feedforward_save("/usd/feedforward.txt", fit.left.ff, fit.right.ff);
+    }
+}
+
+void drive_feedforward_apply(Feedforward left, Feedforward right) {
+    drive_profile_feedforward_set(left, right);
+}
+
+bool drive_feedforward_save(const char* path, Feedforward left, Feedforward right) {
+    FILE* f = fopen(path, "w");
+    if (f == nullptr) return false;
+    // kS kV kA per side, written by drive characterization
+    fprintf(f, "left %f %f %f\nright %f %f %f\n", left.kS, left.kV, left.kA, right.kS, right.kV, right.kA);
+    fclose(f);
+    return true;
+}
+
+bool drive_feedforward_load(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (f == nullptr) return false;
+    Feedforward left, right;
+    bool ok = fscanf(f, " left %lf %lf %lf right %lf %lf %lf", &left.kS, &left.kV, &left.kA, &right.kS, &right.kV,
+                     &right.kA) == 6;
+    fclose(f);
+    if (ok) drive_feedforward_apply(left, right);
+    return ok;
+}
@@ -0,0 +1,95 @@
+#include "main.h"
+#include "organiz/color_sort.h"
+
+static RingClassifier classifier;
+static RingDetector detector;
+static RingTracker tracker;
+static ColorSortTiming timing;
+
+static std::atomic<RingColor> reject{RingColor::NONE};
+static uint32_t eject_until = 0;
+
+// Held while deciding what the intake gets and giving it, so an eject can't
+// start between intake_set() checking for one and moving the motor
+static pros::Mutex intake_mutex;
+static int power = 0;
+static bool ejecting = false;
+static std::atomic<int> red{0}, blue{0}, ejected{0};
+
+static void intake_apply(int p) {
+    if (p == 0) {
+        intake.brake();
+    } else {
+        intake.move(p);
+    }
+}
+
+void intake_set(int p) {
+    intake_mutex.take();
+    power = p;
+    if (!ejecting) intake_apply(p);
+    intake_mutex.give();
+}
+
+static void color_sort_update() {
+    uint32_t now = pros::millis();
+    double position = intake.get_position();
+    double velocity = intake.get_actual_velocity() * 6; // rpm -> deg/s
+
+    OpticalSample sample = {color_checker.get_hue(), color_checker.get_saturation(), color_checker.get_proximity()};
+    RingColor seen = detector.update(ring_classify(sample, classifier));
+    if (seen != RingColor::NONE) {
+        (seen == RingColor::RED ? red : blue)++;
+        // Where the intake was when the sensor saw it, not now
+        tracker.push(seen, position - velocity * timing.sample_age / 1000);
+    }
+
+    RingColor at_top = tracker.update(position, velocity * timing.latency / 1000);
+    intake_mutex.take();
+    if (at_top != RingColor::NONE && at_top == reject && !ejecting) {
+        ejecting = true;
+        eject_until = now + COLOR_SORT_EJECT_TIME;
+        intake.brake();
+        ejected++;
+    }
+    if (ejecting && now >= eject_until) {
+        ejecting = false;
+        intake_apply(power);
+    }
+    intake_mutex.give();
+}
+
+PeriodicLoop color_sort_loop("color sort", COLOR_SORT_PERIOD, color_sort_update);
+
+void color_sort_start() {
+    color_checker.set_integration_time(COLOR_SORT_PERIOD);
+    color_checker.set_led_pwm(100); // rings look the same under any field lighting
+    detector.reset();
+    tracker.clear();
+    color_sort_loop.start();
+}
+
+void color_sort_set(RingColor color) {
+    reject = color;
+}
+
+RingColor color_sort_get() {
+    return reject;
+}
+
+void color_sort_alliance_set(Alliance ours) {
+    color_sort_set(ours == Alliance::RED ? RingColor::BLUE : ours == Alliance::BLUE ? RingColor::RED : RingColor::NONE);
+}
+
+void color_sort_timing_set(ColorSortTiming t) {
+    timing = t;
+    tracker.travel = t.travel;
+}
+
+ColorSortStats color_sort_stats() {
+    return {red, blue, ejected};
+}
+
+void color_sort_stats_reset() {
+    red = blue = ejected = 0;
+}
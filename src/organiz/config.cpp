@@ -0,0 +1,141 @@
+#include <cstring>
+
+#include "main.h"
+#include "organiz/config.h"
+#include "organiz/odometry.h"
+
+static uint32_t defaults_hash = 0;
+
+static PidGains gains_get(const ez::PID& pid) {
+    return {pid.constants.kp, pid.constants.ki, pid.constants.kd, pid.constants.start_i};
+}
+
+static ExitLimits exit_get(const ez::PID& pid) {
+    return {pid.exit.small_exit_time, pid.exit.small_error, pid.exit.big_exit_time,
+            pid.exit.big_error, pid.exit.velocity_exit_time, pid.exit.mA_timeout};
+}
+
+static SlewConstants slew_get(const ez::slew& slew) {
+    return {slew.constants.distance_to_travel, slew.constants.min_speed};
+}
+
+RobotConfig config_capture() {
+    // Padding too, the defaults hash covers every byte
+    RobotConfig c;
+    memset(&c, 0, sizeof(c));
+    c.heading = gains_get(chassis.headingPID);
+    c.drive_forward = gains_get(chassis.forward_drivePID);
+    c.drive_backward = gains_get(chassis.backward_drivePID);
+    c.turn = gains_get(chassis.turnPID);
+    c.swing_forward = gains_get(chassis.forward_swingPID);
+    c.swing_backward = gains_get(chassis.backward_swingPID);
+
+    c.drive_exit = exit_get(chassis.leftPID);
+    c.turn_exit = exit_get(chassis.turnPID);
+    c.swing_exit = exit_get(chassis.swingPID);
+
+    c.slew_drive_forward = slew_get(chassis.slew_forward);
+    c.slew_drive_backward = slew_get(chassis.slew_backward);
+    c.slew_turn = slew_get(chassis.slew_turn);
+    c.slew_swing_forward = slew_get(chassis.slew_swing_forward);
+    c.slew_swing_backward = slew_get(chassis.slew_swing_backward);
+
+    c.chain_drive_forward = chassis.pid_drive_chain_forward_constant_get();
+    c.chain_drive_backward = chassis.pid_drive_chain_backward_constant_get();
+    c.chain_turn = chassis.pid_turn_chain_constant_get();
+    c.chain_swing_forward = chassis.pid_swing_chain_forward_constant_get();
+    c.chain_swing_backward = chassis.pid_swing_chain_backward_constant_get();
+
+    c.profile = drive_profile_constants_get();
+    c.settle_mode = settle_mode_get();
+    c.settle_horizon = settle_horizon_get();
+
+    c.odom_integrator = odom_integrator_get();
+    c.odom_heading = odom_heading_get();
+    c.odom_ekf = odom_ekf_enabled();
+
+    c.arm_limits = lady_brown.limits_get();
+    c.arm_gains = lady_brown.gains_get();
+    c.arm_pid = gains_get(lady_brown.pid);
+    c.arm_exit = exit_get(lady_brown.pid);
+    return c;
+}
+
+void config_apply(const RobotConfig& c) {
+    chassis.pid_heading_constants_set(c.heading.kp, c.heading.ki, c.heading.kd, c.heading.start_i);
+    chassis.pid_drive_constants_forward_set(c.drive_forward.kp, c.drive_forward.ki, c.drive_forward.kd, c.drive_forward.start_i);
+    chassis.pid_drive_constants_backward_set(c.drive_backward.kp, c.drive_backward.ki, c.drive_backward.kd, c.drive_backward.start_i);
+    chassis.pid_turn_constants_set(c.turn.kp, c.turn.ki, c.turn.kd, c.turn.start_i);
+    chassis.pid_swing_constants_forward_set(c.swing_forward.kp, c.swing_forward.ki, c.swing_forward.kd, c.swing_forward.start_i);
+    chassis.pid_swing_constants_backward_set(c.swing_backward.kp, c.swing_backward.ki, c.swing_backward.kd, c.swing_backward.start_i);
+
+    const ExitLimits& d = c.drive_exit;
+    const ExitLimits& t = c.turn_exit;
+    const ExitLimits& s = c.swing_exit;
+    chassis.pid_drive_exit_condition_set(d.small_exit_time, d.small_error, d.big_exit_time, d.big_error, d.velocity_exit_time, d.mA_timeout);
+    chassis.pid_turn_exit_condition_set(t.small_exit_time, t.small_error, t.big_exit_time, t.big_error, t.velocity_exit_time, t.mA_timeout);
+    chassis.pid_swing_exit_condition_set(s.small_exit_time, s.small_error, s.big_exit_time, s.big_error, s.velocity_exit_time, s.mA_timeout);
+
+    chassis.slew_drive_constants_forward_set(c.slew_drive_forward.distance * okapi::inch, c.slew_drive_forward.min_speed);
+    chassis.slew_drive_constants_backward_set(c.slew_drive_backward.distance * okapi::inch, c.slew_drive_backward.min_speed);
+    chassis.slew_turn_constants_set(c.slew_turn.distance * okapi::degree, c.slew_turn.min_speed);
+    chassis.slew_swing_constants_forward_set(c.slew_swing_forward.distance * okapi::degree, c.slew_swing_forward.min_speed);
+    chassis.slew_swing_constants_backward_set(c.slew_swing_backward.distance * okapi::degree, c.slew_swing_backward.min_speed);
+
+    chassis.pid_drive_chain_forward_constant_set(c.chain_drive_forward);
+    chassis.pid_drive_chain_backward_constant_set(c.chain_drive_backward);
+    chassis.pid_turn_chain_constant_set(c.chain_turn);
+    chassis.pid_swing_chain_forward_constant_set(c.chain_swing_forward);
+    chassis.pid_swing_chain_backward_constant_set(c.chain_swing_backward);
+
+    drive_profile_constants_set(c.profile);
+    settle_mode_set(c.settle_mode);
+    settle_horizon_set(c.settle_horizon);
+
+    odom_integrator_set(c.odom_integrator);
+    odom_heading_set(c.odom_heading);
+    odom_ekf_enable(c.odom_ekf);
+
+    lady_brown.constants_set(c.arm_limits, c.arm_gains);
+    lady_brown.pid.constants_set(c.arm_pid.kp, c.arm_pid.ki, c.arm_pid.kd, c.arm_pid.start_i);
+    const ExitLimits& a = c.arm_exit;
+    lady_brown.pid.exit_condition_set(a.small_exit_time, a.small_error, a.big_exit_time, a.big_error, a.velocity_exit_time, a.mA_timeout);
+}
+
+void config_defaults_mark() {
+    RobotConfig c = config_capture();
+    defaults_hash = fnv1a(&c, sizeof(RobotConfig));
+}
+
+// What's on the card, header and config together so it's one read
+struct ConfigFile {
+    ConfigHeader header;
+    RobotConfig config;
+};
+
+bool config_load(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (f == nullptr) return false;
+    static ConfigFile file;
+    bool ok = fread(&file, sizeof(file), 1, f) == 1 && file.header.magic == CONFIG_MAGIC &&
+              file.header.version == CONFIG_VERSION && file.header.size == sizeof(RobotConfig) &&
+              fnv1a(&file.config, sizeof(RobotConfig)) == file.header.checksum &&
+              file.header.defaults == defaults_hash;
+    fclose(f);
+
+    if (ok) config_apply(file.config);
+    return ok;
+}
+
+bool config_save(const char* path) {
+    static ConfigFile file;
+    file.config = config_capture();
+    file.header = {CONFIG_MAGIC, CONFIG_VERSION, sizeof(RobotConfig), fnv1a(&file.config, sizeof(RobotConfig)),
+                   defaults_hash};
+
+    FILE* f = fopen(path, "wb");
+    if (f == nullptr) return false;
+    bool ok = fwrite(&file, sizeof(file), 1, f) == 1;
+    fclose(f);
+    return ok;
+}
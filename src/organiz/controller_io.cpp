@@ -0,0 +1,130 @@
+#include <cstdarg>
+#include <cstring>
+
+#include "main.h"
+#include "organiz/controller_io.h"
+
+static ControllerState state;
+
+static const pros::controller_analog_e_t sticks[4] = {
+    pros::E_CONTROLLER_ANALOG_LEFT_X, pros::E_CONTROLLER_ANALOG_LEFT_Y,
+    pros::E_CONTROLLER_ANALOG_RIGHT_X, pros::E_CONTROLLER_ANALOG_RIGHT_Y};
+
+const ControllerState& controller_poll() {
+    uint32_t held = 0;
+    for (int b = pros::E_CONTROLLER_DIGITAL_L1; b <= pros::E_CONTROLLER_DIGITAL_A; b++) {
+        pros::controller_digital_e_t button = (pros::controller_digital_e_t)b;
+        if (master.get_digital(button)) held |= button_bit(button);
+    }
+    state.pressed = held & ~state.held;
+    state.released = state.held & ~held;
+    state.held = held;
+    for (pros::controller_analog_e_t stick : sticks) state.axes[stick] = master.get_analog(stick);
+    state.lcd_buttons = pros::lcd::read_buttons();
+    return state;
+}
+
+const ControllerState& controller_get() { return state; }
+
+///
+// Screen queue. Writers format outside the lock and only mark a line when
+// its text changed, the ui loop copies the marked lines out and draws them
+// with the lock released.
+///
+struct ScreenLine {
+    char text[32];
+    bool dirty;
+};
+
+static pros::Mutex screen_mutex;
+static ScreenLine lcd_lines[LCD_LINES];
+static ScreenLine controller_lines[CONTROLLER_LINES];
+static char rumble_pattern[9];
+static int controller_next = 0; // line to check first, so one busy line can't starve the others
+
+static void line_set(ScreenLine* lines, int count, int line, const char* fmt, va_list args) {
+    if (line < 0 || line >= count) return;
+    char text[sizeof(lines[0].text)];
+    vsnprintf(text, sizeof(text), fmt, args);
+
+    screen_mutex.take();
+    if (strcmp(text, lines[line].text) != 0) {
+        strcpy(lines[line].text, text);
+        lines[line].dirty = true;
+    }
+    screen_mutex.give();
+}
+
+void lcd_text_set(int line, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    line_set(lcd_lines, LCD_LINES, line, fmt, args);
+    va_end(args);
+}
+
+void controller_text_set(int line, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    line_set(controller_lines, CONTROLLER_LINES, line, fmt, args);
+    va_end(args);
+}
+
+void lcd_redraw() {
+    screen_mutex.take();
+    for (ScreenLine& line : lcd_lines) line.dirty = true;
+    screen_mutex.give();
+}
+
+void controller_rumble(const char* pattern) {
+    screen_mutex.take();
+    strncpy(rumble_pattern, pattern, sizeof(rumble_pattern) - 1);
+    screen_mutex.give();
+}
+
+static void ui_update() {
+    ScreenLine lcd[LCD_LINES];
+    int lcd_count = 0;
+    int lcd_index[LCD_LINES];
+    char controller_text[sizeof(controller_lines[0].text)];
+    int controller_line = -1;
+    char rumble[sizeof(rumble_pattern)] = "";
+
+    screen_mutex.take();
+    for (int i = 0; i < LCD_LINES; i++) {
+        if (!lcd_lines[i].dirty) continue;
+        lcd[lcd_count] = lcd_lines[i];
+        lcd_index[lcd_count++] = i;
+        lcd_lines[i].dirty = false;
+    }
+    // One controller write per period, a rumble goes first
+    if (rumble_pattern[0] != '\0') {
+        strcpy(rumble, rumble_pattern);
+        rumble_pattern[0] = '\0';
+    } else {
+        for (int n = 0; n < CONTROLLER_LINES; n++) {
+            int i = (controller_next + n) % CONTROLLER_LINES;
+            if (!controller_lines[i].dirty) continue;
+            strcpy(controller_text, controller_lines[i].text);
+            controller_lines[i].dirty = false;
+            controller_line = i;
+            controller_next = i + 1;
+            break;
+        }
+    }
+    screen_mutex.give();
+
+    for (int i = 0; i < lcd_count; i++) pros::lcd::set_text(lcd_index[i], lcd[i].text);
+    if (rumble[0] != '\0') {
+        master.rumble(rumble);
+    } else if (controller_line >= 0) {
+        // Padded so a shorter line clears what was there
+        master.print(controller_line, 0, "%-*.*s", CONTROLLER_COLUMNS, CONTROLLER_COLUMNS, controller_text);
+    }
+}
+
+static_assert(UI_PERIOD >= CONTROLLER_WRITE_PERIOD, "the ui loop sends one controller write a tick");
+
+// Below the control loops, a slow screen only delays more screen
+PeriodicLoop ui_loop("ui", UI_PERIOD, ui_update, TASK_PRIORITY_DEFAULT - 1);
+
+void ui_start() { ui_loop.start(); }
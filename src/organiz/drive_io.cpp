@@ -0,0 +1,41 @@
+#include "main.h"
+#include "organiz/drive_io.h"
+
+// Averages of one side of chassis' motors
+template <typename Motors>
+static void side_read(Motors& motors, double& velocity, double& current, double& voltage) {
+    int n = motors.size();
+    velocity = current = voltage = 0;
+    for (auto& motor : motors) {
+        velocity += motor.get_actual_velocity();
+        current += motor.get_current_draw();
+        voltage += motor.get_voltage();
+    }
+    if (n > 0) {
+        velocity /= n;
+        current /= n;
+        voltage /= n;
+    }
+}
+
+void DriveIO::read(DriveSnapshot& out) {
+    out.time = pros::millis();
+    out.left = chassis.drive_sensor_left();
+    out.right = chassis.drive_sensor_right();
+    out.imu = chassis.drive_imu_get();
+    // The IMU's z rate is counterclockwise positive
+    out.gyro_rate = -chassis.imu.get_gyro_rate().z;
+}
+
+void DriveIO::health_read(DriveHealth& out) {
+    side_read(chassis.left_motors, out.left_velocity, out.left_current, out.left_voltage);
+    side_read(chassis.right_motors, out.right_velocity, out.right_current, out.right_voltage);
+}
+
+void DriveIO::set(double left, double right) {
+    // move_voltage() keeps the fraction chassis.drive_set()'s int would drop
+    int left_mv = ez::util::clamp(left, 127.0, -127.0) * (12000.0 / 127.0);
+    int right_mv = ez::util::clamp(right, 127.0, -127.0) * (12000.0 / 127.0);
+    for (auto& motor : chassis.left_motors) motor.move_voltage(left_mv);
+    for (auto& motor : chassis.right_motors) motor.move_voltage(right_mv);
+}
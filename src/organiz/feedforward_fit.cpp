@@ -0,0 +1,62 @@
+#include <algorithm>
+#include <cmath>
+
+#include "organiz/feedforward_fit.h"
+
+void FeedforwardFitter::add(double out, double velocity, double accel) {
+    double x[3] = {velocity > 0 ? 1.0 : velocity < 0 ? -1.0 : 0.0, velocity, accel};
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) xtx(r, c) += x[r] * x[c];
+        xty(r, 0) += x[r] * out;
+    }
+    yy += out * out;
+    y += out;
+    n++;
+}
+
+FeedforwardFit FeedforwardFitter::fit() const {
+    FeedforwardFit out = {};
+    Matrix<3, 3> inv;
+    if (n < 3 || !matrix_invert(xtx, inv)) return out;
+
+    Matrix<3, 1> b = inv * xty;
+    out.ff = {b(0, 0), b(1, 0), b(2, 0)};
+    out.samples = n;
+
+    // Residual sum of squares from the sums: y'y - 2 b'X'y + b'X'X b
+    double sse = yy - 2 * (b.transpose() * xty)(0, 0) + (b.transpose() * xtx * b)(0, 0);
+    double sst = yy - y * y / n;
+    out.r2 = sst > 0 ? 1 - sse / sst : 0;
+    return out;
+}
+
+void feedforward_fit_log(const CharacterizeSample* log, size_t count, FeedforwardFit& left, FeedforwardFit& right,
+                         int window, double v_min) {
+    FeedforwardFitter l, r;
+    size_t w = window;
+    // Velocity at i, and acceleration from the velocities w either side of it
+    auto velocity = [&](size_t i, bool is_left) {
+        double a = is_left ? log[i - w].left : log[i - w].right;
+        double b = is_left ? log[i + w].left : log[i + w].right;
+        return (b - a) / ((log[i + w].time_ms - log[i - w].time_ms) / 1000.0);
+    };
+    size_t last_gap = 0; // index after the latest break between tests
+    for (size_t i = 2 * w; i + 2 * w < count; i++) {
+        for (size_t j = std::max(last_gap, i - 2 * w) + 1; j <= i + 2 * w; j++) {
+            if (log[j].time_ms - log[j - 1].time_ms > FEEDFORWARD_GAP) last_gap = j;
+        }
+        if (last_gap > i - 2 * w) continue;
+        double dt = (log[i + w].time_ms - log[i - w].time_ms) / 1000.0;
+        if (dt <= 0) continue;
+        for (int side = 0; side < 2; side++) {
+            bool is_left = side == 0;
+            double v = velocity(i, is_left);
+            if (std::fabs(v) < v_min) continue;
+            double a = (velocity(i + w, is_left) - velocity(i - w, is_left)) / dt;
+            double out = is_left ? log[i].out_left : log[i].out_right;
+            (is_left ? l : r).add(out, v, a);
+        }
+    }
+    left = l.fit();
+    right = r.fit();
+}
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <cmath>
+
+#include "organiz/field_draw.h"
+
+PixelRect rect_join(const PixelRect& a, const PixelRect& b) {
+    if (a.empty()) return b;
+    if (b.empty()) return a;
+    return {std::min(a.x1, b.x1), std::min(a.y1, b.y1), std::max(a.x2, b.x2), std::max(a.y2, b.y2)};
+}
+
+bool rect_overlap(const PixelRect& a, const PixelRect& b) {
+    return !a.empty() && !b.empty() && a.x1 <= b.x2 && b.x1 <= a.x2 && a.y1 <= b.y2 && b.y1 <= a.y2;
+}
+
+PixelRect rect_bounds(const PixelPoint* points, int count, int pad) {
+    if (count <= 0) return {0, 0, -1, -1};
+    PixelRect r = {points[0].x, points[0].y, points[0].x, points[0].y};
+    for (int i = 1; i < count; i++) {
+        r = rect_join(r, {points[i].x, points[i].y, points[i].x, points[i].y});
+    }
+    return {(int16_t)(r.x1 - pad), (int16_t)(r.y1 - pad), (int16_t)(r.x2 + pad), (int16_t)(r.y2 + pad)};
+}
+
+int32_t moved_area(const PixelRect& old_area, const PixelRect& new_area) {
+    if (rect_overlap(old_area, new_area)) return rect_join(old_area, new_area).area();
+    return old_area.area() + new_area.area();
+}
+
+PixelPoint FieldProjection::to_px(double x, double y) const {
+    const double scale = FIELD_VIEW_PX / FIELD_IN;
+    return {(int16_t)std::lround((origin_x + x) * scale), (int16_t)std::lround(FIELD_VIEW_PX - (origin_y + y) * scale)};
+}
+
+RobotMarker robot_marker(const FieldProjection& proj, double x, double y, double theta, double length, double width) {
+    // 0 deg faces +y, clockwise positive
+    double a = theta * M_PI / 180;
+    double fx = std::sin(a), fy = std::cos(a); // forward
+    double rx = fy, ry = -fx;                  // right
+    double l = length / 2, w = width / 2;
+
+    auto corner = [&](double along, double across) {
+        return proj.to_px(x + fx * along + rx * across, y + fy * along + ry * across);
+    };
+    PixelPoint front_left = corner(l, -w);
+    return {{front_left, corner(l + w / 2, 0), corner(l, w), corner(-l, w), corner(-l, -w), front_left}};
+}
+
+int path_pixels(const FieldProjection& proj, const PathPoint* path, size_t count, PixelPoint* out, int max) {
+    if (count == 0 || max <= 0) return 0;
+    int n = (int)std::min(count, (size_t)max);
+    if (n == 1) {
+        out[0] = proj.to_px(path[0].x, path[0].y);
+        return 1;
+    }
+    for (int i = 0; i < n; i++) {
+        const PathPoint& p = path[i * (count - 1) / (n - 1)];
+        out[i] = proj.to_px(p.x, p.y);
+    }
+    return n;
+}
+
+FramePacer::FramePacer(uint32_t budget_us, int max_skip) : budget_us(budget_us), max_skip(max_skip) {}
+
+bool FramePacer::frame() {
+    if (countdown > 0) {
+        countdown--;
+        return false;
+    }
+    countdown = skip - 1;
+    return true;
+}
+
+void FramePacer::drawn(uint32_t cost_us) {
+    if (cost_us > budget_us) {
+        skip = std::min(skip * 2, max_skip);
+    } else if (cost_us < budget_us / 2 && skip > 1) {
+        skip /= 2;
+    }
+}
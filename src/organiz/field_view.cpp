@@ -0,0 +1,259 @@
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+#include "main.h"
+#include "organiz/field_view.h"
+#include "organiz/odometry.h"
+
+static_assert(sizeof(PixelPoint) == sizeof(lv_point_t), "PixelPoint mirrors lv_point_t");
+
+static const int TARGET_SIZE = 6;
+static const int TEXT_LINES = 4;
+
+static FieldProjection projection;
+static FramePacer pacer(5000);
+static FieldViewStats stats = {};
+
+// LVGL's display task reports what each refresh cost through monitor_cb
+static std::atomic<uint32_t> render_ms{0};
+static std::atomic<uint32_t> render_px{0};
+static void (*pros_monitor_cb)(lv_disp_drv_t*, uint32_t, uint32_t) = nullptr;
+
+static void monitor(lv_disp_drv_t* drv, uint32_t time, uint32_t px) {
+    render_ms += time;
+    render_px += px;
+    if (pros_monitor_cb != nullptr) pros_monitor_cb(drv, time, px);
+}
+
+///
+// Objects
+///
+static lv_obj_t* screen = nullptr;
+static lv_obj_t* llemu_screen = nullptr;
+static lv_obj_t* robot_line;
+static lv_obj_t* path_line;
+static lv_obj_t* target_dot;
+static lv_obj_t* text[TEXT_LINES];
+static char text_shown[TEXT_LINES][32];
+
+// The tiles, drawn once. 240 x 240 at 32 bit colour is too big for LVGL's
+// 32 KB heap, so the canvas draws from here.
+static uint8_t field_buf[LV_CANVAS_BUF_SIZE_TRUE_COLOR(FIELD_VIEW_PX, FIELD_VIEW_PX)];
+
+// Line points are relative to the line object, which sits on their bounds,
+// so a line only ever invalidates the box it's drawn in
+static RobotMarker robot_shown;
+static lv_point_t robot_points[ROBOT_MARKER_POINTS];
+static lv_point_t path_points[FIELD_PATH_POINTS];
+static PixelPoint target_shown;
+static bool target_visible = false;
+
+// Paths come from the auton task, the view picks them up on its next frame
+static pros::Mutex path_mutex;
+static PixelPoint path_pending[FIELD_PATH_POINTS];
+static int path_pending_count = 0;
+static bool path_dirty = false;
+
+static void field_draw() {
+    lv_obj_t* canvas = lv_canvas_create(screen);
+    lv_canvas_set_buffer(canvas, field_buf, FIELD_VIEW_PX, FIELD_VIEW_PX, LV_IMG_CF_TRUE_COLOR);
+    lv_canvas_fill_bg(canvas, lv_color_hex(0x404040), LV_OPA_COVER);
+
+    lv_draw_line_dsc_t seam;
+    lv_draw_line_dsc_init(&seam);
+    seam.color = lv_color_hex(0x202020);
+    seam.width = 1;
+    for (int i = 1; i < 6; i++) {
+        lv_coord_t at = i * FIELD_VIEW_PX / 6;
+        lv_point_t across[2] = {{0, at}, {FIELD_VIEW_PX, at}};
+        lv_point_t down[2] = {{at, 0}, {at, FIELD_VIEW_PX}};
+        lv_canvas_draw_line(canvas, across, 2, &seam);
+        lv_canvas_draw_line(canvas, down, 2, &seam);
+    }
+
+    // The white line across the middle
+    lv_draw_line_dsc_t tape;
+    lv_draw_line_dsc_init(&tape);
+    tape.color = lv_color_white();
+    tape.width = 2;
+    lv_point_t middle[2] = {{FIELD_VIEW_PX / 2, 0}, {FIELD_VIEW_PX / 2, FIELD_VIEW_PX}};
+    lv_canvas_draw_line(canvas, middle, 2, &tape);
+}
+
+static lv_obj_t* line_create(lv_color_t color) {
+    lv_obj_t* line = lv_line_create(screen);
+    lv_obj_set_style_line_color(line, color, 0);
+    lv_obj_set_style_line_width(line, FIELD_LINE_WIDTH, 0);
+    lv_obj_set_style_line_rounded(line, true, 0);
+    return line;
+}
+
+static void view_create() {
+    llemu_screen = lv_scr_act();
+    screen = lv_obj_create(nullptr);
+    lv_obj_clear_flag(screen, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_style_bg_color(screen, lv_color_black(), 0);
+
+    field_draw();
+    path_line = line_create(lv_color_hex(0x3080ff));
+    robot_line = line_create(lv_color_white());
+
+    target_dot = lv_obj_create(screen);
+    lv_obj_set_size(target_dot, TARGET_SIZE, TARGET_SIZE);
+    lv_obj_set_style_radius(target_dot, LV_RADIUS_CIRCLE, 0);
+    lv_obj_set_style_bg_color(target_dot, lv_color_hex(0xff4040), 0);
+    lv_obj_set_style_border_width(target_dot, 0, 0);
+    lv_obj_clear_flag(target_dot, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_flag(target_dot, LV_OBJ_FLAG_HIDDEN);
+
+    for (int i = 0; i < TEXT_LINES; i++) {
+        text[i] = lv_label_create(screen);
+        lv_obj_set_pos(text[i], FIELD_VIEW_PX + 10, 10 + 24 * i);
+        lv_obj_set_style_text_color(text[i], lv_color_white(), 0);
+        lv_label_set_text(text[i], "");
+        text_shown[i][0] = '\0';
+    }
+
+    lv_disp_t* disp = lv_disp_get_default();
+    pros_monitor_cb = disp->driver->monitor_cb;
+    disp->driver->monitor_cb = monitor;
+}
+
+///
+// Frames
+///
+// Moves a line object onto the points' bounds, points taken relative to it
+static void line_set(lv_obj_t* line, lv_point_t* out, const PixelPoint* points, int count) {
+    PixelRect bounds = rect_bounds(points, count);
+    for (int i = 0; i < count; i++) {
+        out[i] = {(lv_coord_t)(points[i].x - bounds.x1), (lv_coord_t)(points[i].y - bounds.y1)};
+    }
+    lv_obj_set_pos(line, bounds.x1 - FIELD_LINE_WIDTH / 2, bounds.y1 - FIELD_LINE_WIDTH / 2);
+    lv_line_set_points(line, out, count);
+}
+
+static void text_set(int line, const char* fmt, ...) {
+    char buf[sizeof(text_shown[0])];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    // Setting a label invalidates it, same text or not
+    if (strcmp(buf, text_shown[line]) == 0) return;
+    strcpy(text_shown[line], buf);
+    lv_label_set_text(text[line], buf);
+}
+
+// Where the running PID motion ends, and a line about it
+static bool target_get(const ez::pose& pose, PixelPoint& out) {
+    ez::e_mode mode = chassis.drive_mode_get();
+    if (mode == ez::DRIVE) {
+        double remaining = (chassis.leftPID.error + chassis.rightPID.error) / 2;
+        double a = pose.theta * M_PI / 180;
+        out = projection.to_px(pose.x + remaining * sin(a), pose.y + remaining * cos(a));
+        text_set(2, "drive %.1f in", remaining);
+        return true;
+    }
+    if (mode == ez::TURN || mode == ez::SWING) {
+        // A heading target, a point a robot length out along it
+        ez::PID& pid = mode == ez::TURN ? chassis.turnPID : chassis.swingPID;
+        double a = pid.target_get() * M_PI / 180;
+        out = projection.to_px(pose.x + FIELD_ROBOT_LENGTH * sin(a), pose.y + FIELD_ROBOT_LENGTH * cos(a));
+        text_set(2, "%s %.0f err %.1f", mode == ez::TURN ? "turn" : "swing", pid.target_get(), pid.error);
+        return true;
+    }
+    text_set(2, "");
+    return false;
+}
+
+static void view_update() {
+    if (!pacer.frame()) {
+        stats.dropped++;
+        return;
+    }
+    uint64_t start = pros::micros();
+    // Whatever LVGL rendered since the last drawn frame is that frame's
+    uint32_t rendered_us = render_ms.exchange(0) * 1000;
+    stats.last_px = render_px.exchange(0);
+
+    ez::pose pose = odom_pose_now();
+    RobotMarker marker = robot_marker(projection, pose.x, pose.y, pose.theta, FIELD_ROBOT_LENGTH, FIELD_ROBOT_WIDTH);
+    if (marker != robot_shown) {
+        robot_shown = marker;
+        line_set(robot_line, robot_points, marker.points, ROBOT_MARKER_POINTS);
+    }
+
+    PixelPoint target;
+    bool has_target = target_get(pose, target);
+    if (has_target != target_visible) {
+        if (has_target) {
+            lv_obj_clear_flag(target_dot, LV_OBJ_FLAG_HIDDEN);
+        } else {
+            lv_obj_add_flag(target_dot, LV_OBJ_FLAG_HIDDEN);
+        }
+        target_visible = has_target;
+    }
+    if (has_target && target != target_shown) {
+        target_shown = target;
+        lv_obj_set_pos(target_dot, target.x - TARGET_SIZE / 2, target.y - TARGET_SIZE / 2);
+    }
+
+    PixelPoint path[FIELD_PATH_POINTS];
+    int path_count = -1;
+    path_mutex.take();
+    if (path_dirty) {
+        memcpy(path, path_pending, sizeof(path));
+        path_count = path_pending_count;
+        path_dirty = false;
+    }
+    path_mutex.give();
+    if (path_count >= 0) line_set(path_line, path_points, path, path_count);
+
+    text_set(0, "x %.1f  y %.1f", pose.x, pose.y);
+    text_set(1, "heading %.1f", pose.theta);
+    text_set(3, "frame %.1f ms  1/%d", stats.last_us / 1000.0, pacer.skip_get());
+
+    stats.frames++;
+    stats.last_us = (pros::micros() - start) + rendered_us;
+    if (stats.last_us > stats.max_us) stats.max_us = stats.last_us;
+    pacer.drawn(stats.last_us);
+}
+
+// One above the lowest priority, under the ui loop and every control loop
+static PeriodicLoop view_loop("field view", FIELD_VIEW_PERIOD, view_update, TASK_PRIORITY_MIN + 1);
+
+void field_view_show(bool show) {
+    if (show == field_view_shown()) return;
+    if (show) {
+        if (screen == nullptr) view_create();
+        llemu_screen = lv_scr_act();
+        lv_scr_load(screen);
+        view_loop.start();
+    } else {
+        view_loop.pause();
+        lv_scr_load(llemu_screen);
+    }
+}
+
+bool field_view_shown() { return view_loop.running(); }
+
+void field_view_origin_set(double x, double y) {
+    projection.origin_x = x;
+    projection.origin_y = y;
+}
+
+void field_view_path_set(const PathPoint* points, size_t count) {
+    PixelPoint px[FIELD_PATH_POINTS];
+    int n = points == nullptr ? 0 : path_pixels(projection, points, count, px, FIELD_PATH_POINTS);
+    path_mutex.take();
+    memcpy(path_pending, px, n * sizeof(PixelPoint));
+    path_pending_count = n;
+    path_dirty = true;
+    path_mutex.give();
+}
+
+void field_view_budget_set(uint32_t us) { pacer.budget_set(us); }
+
+FieldViewStats field_view_stats() { return stats; }
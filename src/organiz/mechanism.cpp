@@ -0,0 +1,80 @@
+#include <cstring>
+
+#include "main.h"
+#include "organiz/mechanism.h"
+
+ArmController::ArmController(pros::Motor& motor, pros::Rotation& sensor, const ArmState* states, int count)
+    : motor(motor), sensor(sensor), states(states), count(count) {
+    constants.write({{300, 1200, 0}, {}});
+}
+
+void ArmController::constants_set(ProfileLimits limits, ArmGains gains) {
+    limits.jerk = 0; // trapezoid
+    constants.write({limits, gains});
+}
+
+void ArmController::state_set(int index) {
+    if (index < 0 || index >= count) return;
+    state = index;
+    is_settled = false;
+    replan = true;
+}
+
+void ArmController::state_set(const char* name) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(states[i].name, name) == 0) {
+            state_set(i);
+            return;
+        }
+    }
+}
+
+void ArmController::state_next() {
+    state_set((state + 1) % count);
+}
+
+double ArmController::position_get() const {
+    return sensor.get_position() / 100.0; // centidegrees
+}
+
+void ArmController::update() {
+    double position = position_get();
+    ArmConstants c = constants.read();
+
+    if (pros::competition::is_disabled()) {
+        replan = true;
+        return;
+    }
+
+    // Plan on this task, so profile is never read while it's being written
+    if (replan.exchange(false)) {
+        start_position = position;
+        start_time = pros::millis();
+        profile = MotionProfile(states[state.load()].position - position, c.limits);
+        pid.variables_reset();
+        pid.timers_reset();
+        is_settled = false;
+    }
+
+    double t = (pros::millis() - start_time) / 1000.0;
+    ProfilePoint p = profile.at(t);
+    pid.target_set(start_position + p.position);
+
+    const ArmGains& g = c.gains;
+    double ff = g.kG * cos((position - g.level) * M_PI / 180) + g.kS * ez::util::sgn(p.velocity) + g.kV * p.velocity +
+                g.kA * p.accel;
+    double out = ez::util::clamp(ff + pid.compute(position), 127.0, -127.0);
+    motor.move_voltage(out * (12000.0 / 127.0));
+
+    // Exit conditions only mean something once the setpoint stops moving
+    if (t >= profile.duration() && !is_settled) {
+        is_settled = pid.exit_condition() != ez::RUNNING;
+    }
+}
+
+void ArmController::wait_until_settled(int timeout_ms) {
+    pros::delay(ez::util::DELAY_TIME); // let update() pick up a new state
+    for (int waited = 0; !is_settled && waited < timeout_ms; waited += ez::util::DELAY_TIME) {
+        pros::delay(ez::util::DELAY_TIME);
+    }
+}
@@ -0,0 +1,162 @@
+#include <cmath>
+#include <cstdio>
+
+#include "organiz/motion_profile.h"
+
+// Getting from rest to v (or v to rest): jerk time, constant accel time and
+// the peak accel used. Returns the distance it takes.
+static double ramp(double v, const ProfileLimits& limits, double& t_jerk, double& t_accel, double& a_peak) {
+    if (limits.jerk <= 0) {
+        t_jerk = 0;
+        t_accel = v / limits.accel;
+        a_peak = limits.accel;
+    } else if (v * limits.jerk >= limits.accel * limits.accel) {
+        t_jerk = limits.accel / limits.jerk;
+        t_accel = v / limits.accel - t_jerk;
+        a_peak = limits.accel;
+    } else {
+        // Never reaches max accel
+        t_jerk = std::sqrt(v / limits.jerk);
+        t_accel = 0;
+        a_peak = limits.jerk * t_jerk;
+    }
+    // Symmetric ramp, average speed is v / 2
+    return v * (2 * t_jerk + t_accel) / 2;
+}
+
+static ProfilePoint advance(ProfilePoint p, double jerk, double dt) {
+    return {
+        p.position + p.velocity * dt + p.accel * dt * dt / 2 + jerk * dt * dt * dt / 6,
+        p.velocity + p.accel * dt + jerk * dt * dt / 2,
+        p.accel + jerk * dt,
+    };
+}
+
+MotionProfile::MotionProfile(double distance, ProfileLimits p_limits) : limits(p_limits), target(distance) {
+    double d = std::fabs(distance);
+    double t_jerk, t_accel, a_peak;
+
+    // Cruise at max velocity if there is room, otherwise find the peak
+    // velocity where the two ramps meet
+    double v = limits.velocity;
+    if (2 * ramp(v, limits, t_jerk, t_accel, a_peak) > d) {
+        double lo = 0, hi = v;
+        for (int i = 0; i < 50; i++) {
+            v = (lo + hi) / 2;
+            if (2 * ramp(v, limits, t_jerk, t_accel, a_peak) > d)
+                hi = v;
+            else
+                lo = v;
+        }
+        v = lo;
+    }
+    double ramp_distance = ramp(v, limits, t_jerk, t_accel, a_peak);
+    double t_cruise = v > 0 ? (d - 2 * ramp_distance) / v : 0;
+
+    double j = limits.jerk;
+    // {length, jerk, accel at the start}, accel steps only happen on a trapezoid
+    const double plan[7][3] = {
+        {t_jerk, j, j > 0 ? 0 : a_peak},
+        {t_accel, 0, a_peak},
+        {t_jerk, -j, a_peak},
+        {t_cruise, 0, 0},
+        {t_jerk, -j, j > 0 ? 0 : -a_peak},
+        {t_accel, 0, -a_peak},
+        {t_jerk, j, -a_peak},
+    };
+
+    ProfilePoint p = {0, 0, 0};
+    double t = 0;
+    for (int i = 0; i < 7; i++) {
+        p.accel = plan[i][2];
+        segments[i] = {t, plan[i][0], plan[i][1], p};
+        p = advance(p, plan[i][1], plan[i][0]);
+        t += plan[i][0];
+    }
+    total_time = t;
+}
+
+ProfilePoint MotionProfile::at(double t) const {
+    if (t >= total_time) return {target, 0, 0};
+    if (t < 0) t = 0;
+
+    int i = 0;
+    while (i < 6 && t >= segments[i].start + segments[i].length) i++;
+    const Segment& s = segments[i];
+    ProfilePoint p = advance(s.begin, s.jerk, t - s.start);
+
+    if (target < 0) return {-p.position, -p.velocity, -p.accel};
+    return p;
+}
+
+///
+// Cache
+///
+static const int CACHE_SIZE = 16;
+static MotionProfile cache[CACHE_SIZE];
+static bool cache_used[CACHE_SIZE];
+static int cache_next = 0;
+
+static MotionProfile pack[PROFILE_PACK_MAX];
+static int pack_count = 0;
+
+const MotionProfile& profile_get(double distance, ProfileLimits limits) {
+    for (int i = 0; i < pack_count; i++) {
+        if (pack[i].distance() == distance && pack[i].limits_get() == limits) return pack[i];
+    }
+    for (int i = 0; i < CACHE_SIZE; i++) {
+        if (cache_used[i] && cache[i].distance() == distance && cache[i].limits_get() == limits) return cache[i];
+    }
+
+    // Round robin, autons rarely use more than a handful of distances
+    int slot = cache_next;
+    cache_next = (cache_next + 1) % CACHE_SIZE;
+    cache[slot] = MotionProfile(distance, limits);
+    cache_used[slot] = true;
+    return cache[slot];
+}
+
+///
+// Packs
+///
+uint32_t fnv1a(const void* data, size_t size) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+int profile_pack_load(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (f == nullptr) return -1;
+
+    // Read straight into the pack, only keep it if it checks out
+    ProfilePackHeader header;
+    bool ok = fread(&header, sizeof(header), 1, f) == 1 && header.magic == PROFILE_PACK_MAGIC &&
+              header.version == PROFILE_PACK_VERSION && header.record_size == sizeof(MotionProfile) &&
+              header.count <= PROFILE_PACK_MAX && fread(pack, sizeof(MotionProfile), header.count, f) == header.count &&
+              fnv1a(pack, header.count * sizeof(MotionProfile)) == header.checksum;
+    fclose(f);
+
+    pack_count = ok ? header.count : 0;
+    return ok ? pack_count : -1;
+}
+
+bool profile_pack_write(const char* path) {
+    static MotionProfile out[PROFILE_PACK_MAX];
+    int count = 0;
+    for (int i = 0; i < pack_count && count < PROFILE_PACK_MAX; i++) out[count++] = pack[i];
+    for (int i = 0; i < CACHE_SIZE && count < PROFILE_PACK_MAX; i++) {
+        if (cache_used[i]) out[count++] = cache[i];
+    }
+
+    FILE* f = fopen(path, "wb");
+    if (f == nullptr) return false;
+    ProfilePackHeader header = {PROFILE_PACK_MAGIC, PROFILE_PACK_VERSION, sizeof(MotionProfile), (uint32_t)count,
+                                fnv1a(out, count * sizeof(MotionProfile))};
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 && fwrite(out, sizeof(MotionProfile), count, f) == (size_t)count;
+    fclose(f);
+    return ok;
+}
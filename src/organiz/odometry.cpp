@@ -0,0 +1,195 @@
+#include "main.h"
+#include "organiz/odometry.h"
+
+static Seqlock<OdomState> published;
+
+// Written by odom_reset, applied by the odom task
+static std::atomic<bool> reset_pending{true};
+static double reset_x = 0, reset_y = 0;
+
+static std::atomic<OdomIntegrator> integrator{OdomIntegrator::ARC};
+static std::atomic<OdomHeading> heading_source{OdomHeading::IMU};
+
+static PoseEkf ekf;
+static std::atomic<bool> ekf_on{false};
+static std::atomic<pros::Gps*> gps{nullptr};
+static double gps_origin_x = 0, gps_origin_y = 0;
+static std::atomic<OdomCorrector> corrector{nullptr};
+
+// Corrections not handed to EZ's odom yet, only touched by the odom task
+static double ez_dx = 0, ez_dy = 0;
+
+// EZ's task is the only other writer of its pose. The odom task is above it,
+// so EZ can't run between the read and the write here, but the odom task may
+// have preempted it halfway through its own update. Only when it's blocked in
+// its delay is it safe, otherwise the correction waits for the next step.
+static void ez_correct(double dx, double dy) {
+    ez_dx += dx;
+    ez_dy += dy;
+    if ((ez_dx == 0 && ez_dy == 0) || chassis.ez_auto.get_state() != pros::E_TASK_STATE_BLOCKED) return;
+    ez::pose ez_pose = chassis.odom_pose_get();
+    chassis.odom_xy_set(ez_pose.x + ez_dx, ez_pose.y + ez_dy);
+    ez_dx = ez_dy = 0;
+}
+
+// Runs the EKF over the step and replaces state's pose with its estimate.
+// Corrections from the GPS and the corrector are handed on to EZ's odom too.
+static void ekf_update(OdomState& state, const DriveSnapshot& snap, double d, double wheel_delta, double dt) {
+    static uint32_t gps_last = 0;
+
+    ekf.step(d, wheel_delta, dt);
+    ekf.update_heading(state.theta);
+    double x = ekf.x(), y = ekf.y();
+
+    pros::Gps* g = gps.load();
+    if (g != nullptr && snap.time - gps_last >= ODOM_GPS_PERIOD) {
+        gps_last = snap.time;
+        // Meters on the GPS's field
+        ekf.update_position(g->get_position_x() * 39.37 - gps_origin_x, g->get_position_y() * 39.37 - gps_origin_y,
+                            g->get_error() * 39.37);
+    }
+    OdomCorrector c = corrector.load();
+    if (c != nullptr) c(ekf, snap);
+
+    ez_correct(ekf.x() - x, ekf.y() - y);
+
+    double heading = ekf.theta() * M_PI / 180;
+    state.x = ekf.x();
+    state.y = ekf.y();
+    state.vx = ekf.velocity() * sin(heading);
+    state.vy = ekf.velocity() * cos(heading);
+    state.omega = ekf.omega();
+}
+
+static void update() {
+    static OdomState state = {};
+    static double prev_left = 0, prev_right = 0;
+    static HeadingFilter filter;
+
+    DriveSnapshot snap;
+    drive_io.read(snap);
+    uint64_t now = pros::micros();
+
+    if (reset_pending.exchange(false)) {
+        state = {now, reset_x, reset_y, snap.imu, 0, 0, 0};
+        prev_left = snap.left;
+        prev_right = snap.right;
+        filter.theta = snap.imu;
+        ekf.reset(reset_x, reset_y, snap.imu);
+        ez_dx = ez_dy = 0;
+        published.write(state);
+        return;
+    }
+
+    double dl = snap.left - prev_left;
+    double dr = snap.right - prev_right;
+    double d = (dl + dr) / 2;
+    double dt = (now - state.time_us) / 1e6;
+
+    // Heading change of the step, deg. Without a track width the wheels
+    // can't give one, so the IMU's stands in and the heading stays on it.
+    double width = chassis.drive_width_get();
+    double wheel_delta = width > 0 ? (dl - dr) / width * 180 / M_PI : snap.imu - state.theta;
+    double d_theta;
+    switch (width > 0 ? heading_source.load() : OdomHeading::IMU) {
+        case OdomHeading::WHEELS:
+            d_theta = wheel_delta;
+            break;
+        case OdomHeading::FUSED:
+            d_theta = filter.update(snap.gyro_rate * dt, wheel_delta, snap.imu) - state.theta;
+            break;
+        default:
+            d_theta = snap.imu - state.theta;
+            break;
+    }
+
+    OdomStep step = odom_step(integrator.load(), d, d_theta * M_PI / 180);
+    double dir = state.theta * M_PI / 180 + step.angle;
+    double dx = step.length * sin(dir);
+    double dy = step.length * cos(dir);
+
+    state.x += dx;
+    state.y += dy;
+    state.theta += d_theta;
+    if (dt > 0) {
+        state.vx = dx / dt;
+        state.vy = dy / dt;
+        state.omega = d_theta / dt;
+    }
+    if (ekf_on) ekf_update(state, snap, d, wheel_delta, dt);
+    state.time_us = now;
+
+    prev_left = snap.left;
+    prev_right = snap.right;
+    published.write(state);
+}
+
+static PeriodicLoop odom_loop("odom", ODOM_PERIOD, update, TASK_PRIORITY_DEFAULT + 2);
+
+void odom_start() {
+    chassis.left_rotation.set_data_rate(ODOM_PERIOD);
+    chassis.right_rotation.set_data_rate(ODOM_PERIOD);
+    chassis.imu.set_data_rate(ODOM_PERIOD);
+    odom_loop.start();
+}
+
+void odom_integrator_set(OdomIntegrator p_integrator) {
+    integrator = p_integrator;
+}
+
+OdomIntegrator odom_integrator_get() {
+    return integrator;
+}
+
+bool odom_heading_set(OdomHeading heading) {
+    if (heading != OdomHeading::IMU && chassis.drive_width_get() <= 0) {
+        printf("odom: no drive width, heading stays on the IMU\n");
+        return false;
+    }
+    heading_source = heading;
+    return true;
+}
+
+OdomHeading odom_heading_get() {
+    return heading_source;
+}
+
+void odom_ekf_enable(bool enable) {
+    if (enable && !ekf_on) odom_reset(odom_state().x, odom_state().y);
+    ekf_on = enable;
+}
+
+bool odom_ekf_enabled() {
+    return ekf_on;
+}
+
+void odom_gps_set(pros::Gps* p_gps, double origin_x, double origin_y) {
+    gps_origin_x = origin_x;
+    gps_origin_y = origin_y;
+    if (p_gps != nullptr) p_gps->set_data_rate(ODOM_GPS_PERIOD);
+    gps = p_gps;
+}
+
+void odom_corrector_set(OdomCorrector p_corrector) {
+    corrector = p_corrector;
+}
+
+void odom_reset(double x, double y) {
+    reset_x = x;
+    reset_y = y;
+    reset_pending = true;
+}
+
+OdomState odom_state() {
+    return published.read();
+}
+
+ez::pose odom_pose_at(uint64_t time_us) {
+    OdomState s = published.read();
+    double dt = time_us > s.time_us ? (time_us - s.time_us) / 1e6 : 0;
+    return {s.x + s.vx * dt, s.y + s.vy * dt, s.theta + s.omega * dt};
+}
+
+ez::pose odom_pose_now() {
+    return odom_pose_at(pros::micros());
+}
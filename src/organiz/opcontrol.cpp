@@ -1,37 +1,22 @@
 #include "main.h"
 #include "organiz/organize.h"
 
-void intake_func() {
-    pros::c::optical_rgb_s_t rgbval = color_checker.get_rgb();
-    if (rgbval.blue > 230 && rgbval.red < 230) {
-        //blue ring is in the intake
-        
-    } else if (rgbval.red > 230 && rgbval.blue < 230) {
-        //red ring is in the intake
-        
-    } else {
-        
-    }
-}
-
-const int numStates = 3;
-int states[numStates] = {0, 30, 200};
-int currState = 0;
-int target = 0;
+// Deg on ladyBrownSensor, 0 at rest. The old P loop's targets read as
+// degrees, check each against the sensor with the arm held there.
+const ArmState lb_states[] = {
+    {"rest", 0},
+    {"load", 30},
+    {"score", 200},
+};
+ArmController lady_brown(ladybrown, ladyBrownSensor, lb_states, 3);
 
 void lb_nextState() {
-    currState += 1;
-    if (currState == numStates) {
-        currState = 0;
-    }
-    target = states[currState];
+    lady_brown.state_next();
 }
 
 void lb_liftControl() {
-    double kP = 1;
-    double error = target - ladyBrownSensor.get_position();
-    double velocity = kP * error;
-
-    ladybrown.move(velocity);
-
+    lady_brown.update();
 }
+
+// Lady brown runs on its own fixed-rate loop, started in initialize()
+PeriodicLoop lb_loop("lady brown", ez::util::DELAY_TIME, lb_liftControl);
@@ -0,0 +1,98 @@
+#include "main.h"
+#include "organiz/path_drive.h"
+#include "organiz/ring_buffer.h"
+
+static PathCache cache;
+static PathSmoothing smoothing;
+static PathStats stats = {};
+
+// Plans waiting for the smoothing loop. Only slots that are done smoothing
+// get reused, so there are never more than PATH_CACHE_SLOTS in here.
+static RingBuffer<PlannedPath*, PATH_CACHE_SLOTS> smooth_queue;
+static PlannedPath* smoothing_now = nullptr;
+
+static void smooth_update() {
+    if (smoothing_now == nullptr && smooth_queue.pop(&smoothing_now, 1) == 0) return;
+    if (path_smooth_step(*smoothing_now, PATH_SWEEPS_PER_PERIOD)) smoothing_now = nullptr;
+}
+
+static PeriodicLoop smooth_loop("path smooth", PATH_SMOOTH_PERIOD, smooth_update, TASK_PRIORITY_MIN + 1);
+
+// Reused for EZ, which takes its path as a vector
+static std::vector<ez::odom> handoff;
+
+void path_smoothing_set(const PathSmoothing& p_smoothing) { smoothing = p_smoothing; }
+const PathSmoothing& path_smoothing_get() { return smoothing; }
+
+// A new path is smoothed on the spot when now is set, and queued for the loop
+// otherwise
+static PlannedPath* plan(const ez::odom* waypoints, size_t count, bool now) {
+    if (count > PATH_MAX_WAYPOINTS) return nullptr;
+    PathPoint points[PATH_MAX_WAYPOINTS];
+    for (size_t i = 0; i < count; i++) points[i] = {waypoints[i].target.x, waypoints[i].target.y};
+
+    uint32_t misses = cache.misses;
+    PlannedPath* path = cache.plan(points, count, smoothing);
+    if (path == nullptr || cache.misses == misses || path->smoothed.load(std::memory_order_acquire)) return path;
+
+    // Not queued, so nothing else has it
+    if (now) {
+        stats.smoothed_now++;
+        path_smooth_step(*path, smoothing.max_sweeps);
+        return path;
+    }
+    if (!smooth_loop.running()) smooth_loop.start();
+    if (!smooth_queue.push(path)) path_smooth_step(*path, smoothing.max_sweeps);
+    return path;
+}
+
+void path_prepare(const ez::odom* waypoints, size_t count) { plan(waypoints, count, false); }
+void path_prepare(std::initializer_list<ez::odom> waypoints) { plan(waypoints.begin(), waypoints.size(), false); }
+
+void pid_path_set(const ez::odom* waypoints, size_t count, bool slew, bool raw_first) {
+    // The first waypoint is where the robot already is, one alone goes nowhere
+    if (count < 2) return;
+    PlannedPath* path = plan(waypoints, count, !raw_first);
+    if (path == nullptr) {
+        // EZ starts from the robot, the first waypoint is where it already is
+        stats.fallbacks++;
+        chassis.pid_odom_injected_pp_set(std::vector<ez::odom>(waypoints + 1, waypoints + count), slew);
+        return;
+    }
+
+    // Unsmoothed here means the loop has it, and may be partway through it
+    bool smooth = path->smoothed.load(std::memory_order_acquire);
+    if (!smooth && !raw_first) {
+        stats.waits++;
+        while (!path->smoothed.load(std::memory_order_acquire)) pros::delay(PATH_SMOOTH_PERIOD);
+        smooth = true;
+    }
+    const PathPoint* points = smooth ? path->smooth : path->raw;
+    if (smooth) {
+        stats.last_sweeps = path->sweeps;
+    } else {
+        stats.raw_starts++;
+    }
+
+    handoff.reserve(PATH_MAX_POINTS);
+    handoff.clear();
+    for (size_t i = 0; i < path->count; i++) {
+        const ez::odom& w = waypoints[path->segment[i]];
+        handoff.push_back(
+            {{points[i].x, points[i].y, ez::ANGLE_NOT_SET}, w.drive_direction, w.max_xy_speed, w.turn_behavior});
+    }
+    handoff.back().target.theta = waypoints[count - 1].target.theta;
+    chassis.pid_odom_pp_set(handoff, slew);
+    field_view_path_set(points, path->count);
+}
+
+void pid_path_set(std::initializer_list<ez::odom> waypoints, bool slew, bool raw_first) {
+    pid_path_set(waypoints.begin(), waypoints.size(), slew, raw_first);
+}
+
+PathStats path_stats() {
+    PathStats s = stats;
+    s.hits = cache.hits;
+    s.misses = cache.misses;
+    return s;
+}
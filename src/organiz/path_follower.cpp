@@ -0,0 +1,19 @@
+#include "organiz/path_follower.h"
+
+std::vector<PathPoint> inject_points(const std::vector<PathPoint>& waypoints, double spacing) {
+    std::vector<PathPoint> path;
+    if (waypoints.empty()) return path;
+
+    for (size_t i = 0; i + 1 < waypoints.size(); i++) {
+        const PathPoint& a = waypoints[i];
+        const PathPoint& b = waypoints[i + 1];
+        double length = std::hypot(b.x - a.x, b.y - a.y);
+        int steps = (int)std::ceil(length / spacing);
+        for (int s = 0; s < steps; s++) {
+            double t = (double)s / steps;
+            path.push_back({a.x + t * (b.x - a.x), a.y + t * (b.y - a.y)});
+        }
+    }
+    path.push_back(waypoints.back());
+    return path;
+}
@@ -0,0 +1,118 @@
+#include <cmath>
+#include <cstring>
+
+#include "organiz/motion_profile.h"
+#include "organiz/path_plan.h"
+
+uint32_t path_key(const PathPoint* waypoints, size_t count, double spacing, const PathSmoothing& smoothing) {
+    // Hashed as plain doubles so struct padding never gets in
+    double data[PATH_MAX_WAYPOINTS * 2 + 5];
+    size_t n = 0;
+    for (size_t i = 0; i < count && i < PATH_MAX_WAYPOINTS; i++) {
+        data[n++] = waypoints[i].x;
+        data[n++] = waypoints[i].y;
+    }
+    data[n++] = spacing;
+    data[n++] = smoothing.weight_smooth;
+    data[n++] = smoothing.weight_data;
+    data[n++] = smoothing.tolerance;
+    data[n++] = smoothing.max_sweeps;
+    return fnv1a(data, n * sizeof(double));
+}
+
+size_t inject_points(const PathPoint* waypoints, size_t count, PathPoint* out, uint8_t* segment, size_t capacity,
+                     double spacing) {
+    if (count == 0 || capacity == 0) return 0;
+
+    size_t n = 0;
+    for (size_t i = 0; i + 1 < count; i++) {
+        const PathPoint& a = waypoints[i];
+        const PathPoint& b = waypoints[i + 1];
+        double length = std::hypot(b.x - a.x, b.y - a.y);
+        int steps = (int)std::ceil(length / spacing);
+        if (n + steps >= capacity) return 0;
+        for (int s = 0; s < steps; s++) {
+            double t = (double)s / steps;
+            out[n] = {a.x + t * (b.x - a.x), a.y + t * (b.y - a.y)};
+            segment[n++] = i + 1;
+        }
+    }
+    out[n] = waypoints[count - 1];
+    segment[n++] = count - 1;
+    return n;
+}
+
+bool path_smooth_step(PlannedPath& path, int sweeps) {
+    if (path.smoothed.load(std::memory_order_acquire)) return true;
+
+    const PathSmoothing& s = path.smoothing;
+    const PathPoint* raw = path.raw;
+    PathPoint* p = path.smooth;
+    bool done = path.count < 3;
+    for (int k = 0; k < sweeps && !done; k++) {
+        // In place like EZ's, so each point sees its neighbour's new spot
+        double change = 0;
+        for (size_t i = 1; i + 1 < path.count; i++) {
+            double x = p[i].x;
+            double y = p[i].y;
+            p[i].x += s.weight_data * (raw[i].x - x) + s.weight_smooth * (p[i - 1].x + p[i + 1].x - 2 * x);
+            p[i].y += s.weight_data * (raw[i].y - y) + s.weight_smooth * (p[i - 1].y + p[i + 1].y - 2 * y);
+            change += std::fabs(p[i].x - x) + std::fabs(p[i].y - y);
+        }
+        path.change = change;
+        path.sweeps++;
+        done = change < s.tolerance || path.sweeps >= s.max_sweeps;
+    }
+
+    if (done) path.smoothed.store(true, std::memory_order_release);
+    return done;
+}
+
+static bool same_plan(const PlannedPath& slot, const PathPoint* waypoints, size_t count, double spacing,
+                      const PathSmoothing& smoothing) {
+    if (slot.waypoint_count != count || slot.spacing != spacing || !(slot.smoothing == smoothing)) return false;
+    for (size_t i = 0; i < count; i++) {
+        if (slot.waypoints[i].x != waypoints[i].x || slot.waypoints[i].y != waypoints[i].y) return false;
+    }
+    return true;
+}
+
+PlannedPath* PathCache::plan(const PathPoint* waypoints, size_t count, const PathSmoothing& smoothing,
+                             double spacing) {
+    if (count == 0 || count > PATH_MAX_WAYPOINTS) return nullptr;
+    clock++;
+
+    uint32_t key = path_key(waypoints, count, spacing, smoothing);
+    PlannedPath* victim = nullptr;
+    for (PlannedPath& slot : slots) {
+        if (slot.count > 0 && slot.key == key && same_plan(slot, waypoints, count, spacing, smoothing)) {
+            slot.used = clock;
+            hits++;
+            return &slot;
+        }
+        // Slots still smoothing may be in use by whoever is smoothing them
+        bool free = slot.count == 0 || slot.smoothed.load(std::memory_order_acquire);
+        if (free && (victim == nullptr || slot.used < victim->used)) victim = &slot;
+    }
+    misses++;
+    if (victim == nullptr) return nullptr;
+
+    size_t n = inject_points(waypoints, count, victim->raw, victim->segment, PATH_MAX_POINTS, spacing);
+    if (n == 0) {
+        victim->count = 0; // partly overwritten
+        return nullptr;
+    }
+
+    victim->key = key;
+    victim->count = n;
+    memcpy(victim->smooth, victim->raw, n * sizeof(PathPoint));
+    victim->sweeps = 0;
+    victim->change = 0;
+    memcpy(victim->waypoints, waypoints, count * sizeof(PathPoint));
+    victim->waypoint_count = count;
+    victim->spacing = spacing;
+    victim->smoothing = smoothing;
+    victim->used = clock;
+    victim->smoothed.store(n < 3, std::memory_order_release);
+    return victim;
+}
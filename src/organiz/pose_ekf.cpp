@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <cmath>
+
+#include "organiz/pose_ekf.h"
+
+static const double DEG = M_PI / 180;
+
+void PoseEkf::reset(double x, double y, double theta) {
+    s = State();
+    s(0, 0) = x;
+    s(1, 0) = y;
+    s(2, 0) = theta * DEG;
+    P = Covariance();
+    P(0, 0) = P(1, 1) = 0.25;
+    P(2, 2) = (1 * DEG) * (1 * DEG);
+}
+
+double PoseEkf::theta() const {
+    return s(2, 0) / DEG;
+}
+
+double PoseEkf::omega() const {
+    return s(4, 0) / DEG;
+}
+
+template <int M>
+bool PoseEkf::correct(const Matrix<M, 1>& innovation, const Matrix<M, N>& H, const Matrix<M, M>& R, bool gated) {
+    Matrix<N, M> Ht = H.transpose();
+    Matrix<M, M> S = H * P * Ht + R;
+    Matrix<M, M> S_inv;
+    if (!matrix_invert(S, S_inv)) return false;
+
+    // Mahalanobis distance of the innovation, throws out readings that can't
+    // be right. NaN compares false, so it's checked on its own.
+    double d2 = (innovation.transpose() * S_inv * innovation)(0, 0);
+    if (!std::isfinite(d2) || (gated && d2 > noise.gate * noise.gate * M)) return false;
+
+    Matrix<N, M> K = P * Ht * S_inv;
+    s = s + K * innovation;
+    P = (Covariance::identity() - K * H) * P;
+
+    // Keep P symmetric against rounding
+    for (int r = 0; r < N; r++)
+        for (int c = r + 1; c < N; c++) P(r, c) = P(c, r) = (P(r, c) + P(c, r)) / 2;
+    return true;
+}
+
+void PoseEkf::step(double d, double d_theta, double dt) {
+    if (!(dt > 0) || !std::isfinite(d) || !std::isfinite(d_theta)) return;
+
+    // v and omega wander between steps, then the wheels say what they averaged
+    P(3, 3) += noise.accel * dt * noise.accel * dt;
+    P(4, 4) += noise.alpha * dt * noise.alpha * dt;
+
+    Matrix<2, 1> z;
+    z(0, 0) = d / dt - s(3, 0);
+    z(1, 0) = d_theta * DEG / dt - s(4, 0);
+    Matrix<2, N> H;
+    H(0, 3) = 1;
+    H(1, 4) = 1;
+    Matrix<2, 2> R;
+    R(0, 0) = (noise.wheel / dt) * (noise.wheel / dt);
+    R(1, 1) = (noise.wheel_turn * DEG / dt) * (noise.wheel_turn * DEG / dt);
+    // Never gate the wheels, they are what carries the filter
+    correct(z, H, R, false);
+
+    // Move along the arc at the corrected speeds
+    double v = s(3, 0), w = s(4, 0), th = s(2, 0);
+    double turn = w * dt;
+    double chord = std::fabs(turn) < 1e-9 ? v * dt : 2 * v / w * std::sin(turn / 2);
+    double mid = th + turn / 2;
+    double sin_m = std::sin(mid), cos_m = std::cos(mid);
+    s(0, 0) += chord * sin_m;
+    s(1, 0) += chord * cos_m;
+    s(2, 0) += turn;
+
+    // Jacobian of the move, the chord taken as v dt
+    Covariance F = Covariance::identity();
+    F(0, 2) = v * dt * cos_m;
+    F(0, 3) = dt * sin_m;
+    F(0, 4) = v * dt * cos_m * dt / 2;
+    F(1, 2) = -v * dt * sin_m;
+    F(1, 3) = dt * cos_m;
+    F(1, 4) = -v * dt * sin_m * dt / 2;
+    F(2, 4) = dt;
+    P = F * P * F.transpose();
+
+    double slip = noise.slip * std::fabs(chord);
+    P(0, 0) += slip * slip;
+    P(1, 1) += slip * slip;
+}
+
+void PoseEkf::update_heading(double theta) {
+    if (!std::isfinite(theta)) return;
+    Matrix<1, 1> z;
+    z(0, 0) = theta * DEG - s(2, 0);
+    Matrix<1, N> H;
+    H(0, 2) = 1;
+    Matrix<1, 1> R;
+    R(0, 0) = (noise.imu * DEG) * (noise.imu * DEG);
+    correct(z, H, R);
+}
+
+bool PoseEkf::update_position(double x, double y, double stddev) {
+    // A GPS without a fix reads PROS_ERR_F, which is inf
+    if (!std::isfinite(x) || !std::isfinite(y) || !std::isfinite(stddev)) return false;
+    if (stddev <= 0) stddev = noise.gps;
+    Matrix<2, 1> z;
+    z(0, 0) = x - s(0, 0);
+    z(1, 0) = y - s(1, 0);
+    Matrix<2, N> H;
+    H(0, 0) = 1;
+    H(1, 1) = 1;
+    Matrix<2, 2> R;
+    R(0, 0) = R(1, 1) = stddev * stddev;
+    return correct(z, H, R);
+}
+
+// Distance along the sensor's ray to the closest segment, -1 if none
+static double ray_cast(double x, double y, double theta, const RangeMount& mount, const FieldSegment* segments,
+                       int count) {
+    double sx = x + mount.forward * std::sin(theta) + mount.right * std::cos(theta);
+    double sy = y + mount.forward * std::cos(theta) - mount.right * std::sin(theta);
+    double phi = theta + mount.angle * DEG;
+    double dx = std::sin(phi), dy = std::cos(phi);
+
+    double best = -1;
+    for (int i = 0; i < count; i++) {
+        const FieldSegment& seg = segments[i];
+        double ex = seg.x2 - seg.x1, ey = seg.y2 - seg.y1;
+        double denom = dx * ey - dy * ex;
+        if (std::fabs(denom) < 1e-9) continue; // parallel
+        double qx = seg.x1 - sx, qy = seg.y1 - sy;
+        double t = (qx * ey - qy * ex) / denom;
+        double u = (qx * dy - qy * dx) / denom;
+        if (t > 0 && u >= 0 && u <= 1 && (best < 0 || t < best)) best = t;
+    }
+    return best;
+}
+
+double field_ray_cast(double x, double y, double theta, const RangeMount& mount, const FieldSegment* segments, int count) {
+    return ray_cast(x, y, theta * DEG, mount, segments, count);
+}
+
+double PoseEkf::range_expected(const RangeMount& mount, const FieldSegment* segments, int count) const {
+    return ray_cast(s(0, 0), s(1, 0), s(2, 0), mount, segments, count);
+}
+
+bool PoseEkf::update_range(const RangeMount& mount, double reading, const FieldSegment* segments, int count) {
+    if (!std::isfinite(reading) || reading < 0) return false;
+    double x = s(0, 0), y = s(1, 0), th = s(2, 0);
+    double expected = ray_cast(x, y, th, mount, segments, count);
+    if (expected < 0) return false;
+
+    // Central differences, the ray can change which segment it hits
+    const double e_pos = 1e-3, e_th = 1e-5;
+    double xp = ray_cast(x + e_pos, y, th, mount, segments, count);
+    double xm = ray_cast(x - e_pos, y, th, mount, segments, count);
+    double yp = ray_cast(x, y + e_pos, th, mount, segments, count);
+    double ym = ray_cast(x, y - e_pos, th, mount, segments, count);
+    double tp = ray_cast(x, y, th + e_th, mount, segments, count);
+    double tm = ray_cast(x, y, th - e_th, mount, segments, count);
+    if (xp < 0 || xm < 0 || yp < 0 || ym < 0 || tp < 0 || tm < 0) return false;
+
+    Matrix<1, N> H;
+    H(0, 0) = (xp - xm) / (2 * e_pos);
+    H(0, 1) = (yp - ym) / (2 * e_pos);
+    H(0, 2) = (tp - tm) / (2 * e_th);
+
+    Matrix<1, 1> z;
+    z(0, 0) = reading - expected;
+    Matrix<1, 1> R;
+    double sigma = std::max(noise.range, 0.05 * reading);
+    R(0, 0) = sigma * sigma;
+    return correct(z, H, R);
+}
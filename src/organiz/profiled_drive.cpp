@@ -0,0 +1,161 @@
+#include "main.h"
+#include "organiz/profiled_drive.h"
+
+static ProfileLimits limits = {60, 120, 600};
+static Feedforward left_ff = {0, 127 / 76.6, 0.2};
+static Feedforward right_ff = left_ff;
+static double kP = 8;
+static bool characterized = false;
+
+void drive_profile_constants_set(ProfileLimits p_limits, ProfileGains p_gains) {
+    limits = p_limits;
+    left_ff = right_ff = {p_gains.kS, p_gains.kV, p_gains.kA};
+    kP = p_gains.kP;
+    characterized = false;
+}
+
+void drive_profile_feedforward_set(Feedforward left, Feedforward right) {
+    left_ff = left;
+    right_ff = right;
+    characterized = true;
+}
+
+bool drive_profile_characterized() { return characterized; }
+
+DriveProfileConstants drive_profile_constants_get() { return {limits, left_ff, right_ff, kP, characterized}; }
+
+void drive_profile_constants_set(const DriveProfileConstants& constants) {
+    limits = constants.limits;
+    left_ff = constants.left;
+    right_ff = constants.right;
+    kP = constants.kP;
+    characterized = constants.characterized;
+}
+
+void ProfiledMotion::begin(double distance, int speed, double p_l_scale, double p_r_scale, bool p_hold_heading) {
+    ProfileLimits scaled = limits;
+    scaled.velocity *= speed / 127.0;
+    profile = &profile_get(distance, scaled);
+    l_scale = p_l_scale;
+    r_scale = p_r_scale;
+    hold_heading = p_hold_heading;
+    motion_speed = speed;
+
+    DriveSnapshot snap;
+    drive_io.read(snap);
+    l_start = snap.left;
+    r_start = snap.right;
+
+    // Hold the heading the drive starts on, not whatever the last EZ motion
+    // left as the target. The pid_drive_set() at the end keeps it.
+    if (hold_heading) {
+        chassis.headingPID.target_set(snap.imu);
+        chassis.headingPID.variables_reset();
+    }
+
+    // Drive the motors ourselves, EZ's task keeps running odom
+    chassis.drive_mode_set(ez::DISABLE, false);
+    start = pros::millis();
+}
+
+void ProfiledMotion::drive(double p_target, int speed) {
+    type = DRIVE;
+    target = p_target;
+    begin(p_target, speed, 1, 1, true);
+}
+
+void ProfiledMotion::turn(double p_target, int speed) {
+    // No track width, no arcs, so EZ turns it
+    if (chassis.drive_width_get() <= 0) {
+        chassis.pid_turn_set(p_target, speed);
+        return;
+    }
+    type = TURN;
+    target = p_target;
+    // Clockwise is the left side forward, each side on half the track width
+    double arc = (p_target - chassis.drive_imu_get()) * M_PI / 180 * chassis.drive_width_get() / 2;
+    begin(arc, speed, 1, -1, false);
+}
+
+void ProfiledMotion::swing(ez::e_swing p_side, double p_target, int speed) {
+    if (chassis.drive_width_get() <= 0) {
+        chassis.pid_swing_set(p_side, p_target, speed);
+        return;
+    }
+    type = SWING;
+    side = p_side;
+    target = p_target;
+    // The moving side goes around the one holding still
+    double arc = (p_target - chassis.drive_imu_get()) * M_PI / 180 * chassis.drive_width_get();
+    if (p_side == ez::LEFT_SWING) {
+        begin(arc, speed, 1, 0, false);
+    } else {
+        begin(-arc, speed, 0, 1, false);
+    }
+}
+
+bool ProfiledMotion::update() {
+    if (type == NONE) return false;
+    DriveSnapshot snap;
+    drive_io.read(snap);
+    double t = (snap.time - start) / 1000.0;
+    if (t >= profile->duration()) {
+        handoff(snap);
+        return false;
+    }
+    ProfilePoint p = profile->at(t);
+
+    double l_out = feedforward(left_ff, p.velocity * l_scale, p.accel * l_scale) +
+                   kP * (p.position * l_scale - (snap.left - l_start));
+    double r_out = feedforward(right_ff, p.velocity * r_scale, p.accel * r_scale) +
+                   kP * (p.position * r_scale - (snap.right - r_start));
+    double gyro_out = hold_heading ? chassis.headingPID.compute(snap.imu) : 0;
+
+    drive_io.set(l_out + gyro_out, r_out - gyro_out);
+    return true;
+}
+
+// Finish on PID so the end accuracy and exit conditions match pid_drive_set
+void ProfiledMotion::handoff(const DriveSnapshot& snap) {
+    if (type == DRIVE) {
+        double traveled = ((snap.left - l_start) + (snap.right - r_start)) / 2;
+        chassis.pid_drive_set(target - traveled, motion_speed);
+    } else if (type == TURN) {
+        chassis.pid_turn_set(target, motion_speed);
+    } else {
+        chassis.pid_swing_set(side, target, motion_speed);
+    }
+    type = NONE;
+}
+
+double ProfiledMotion::remaining() const {
+    if (type == DRIVE) {
+        DriveSnapshot snap;
+        drive_io.read(snap);
+        return target - ((snap.left - l_start) + (snap.right - r_start)) / 2;
+    }
+    return target - chassis.drive_imu_get();
+}
+
+// Blocks while the motion's profile plays
+static void profiled_run(ProfiledMotion& motion) {
+    while (motion.update()) pros::delay(ez::util::DELAY_TIME);
+}
+
+void drive_profiled(double target, int speed) {
+    ProfiledMotion motion;
+    motion.drive(target, speed);
+    profiled_run(motion);
+}
+
+void turn_profiled(double target, int speed) {
+    ProfiledMotion motion;
+    motion.turn(target, speed);
+    profiled_run(motion);
+}
+
+void swing_profiled(ez::e_swing type, double target, int speed) {
+    ProfiledMotion motion;
+    motion.swing(type, target, speed);
+    profiled_run(motion);
+}
@@ -0,0 +1,74 @@
+#include <cmath>
+
+#include "organiz/relay_tune.h"
+
+RelayExperiment::RelayExperiment(double relay, double hysteresis, int settle, int cycles)
+    : relay(relay), hysteresis(hysteresis), settle(settle), cycles(cycles) {}
+
+double RelayExperiment::update(double error, double t) {
+    if (output == 0) output = error >= 0 ? relay : -relay;
+
+    if (output < 0 && error > hysteresis) {
+        output = relay;
+        ups++;
+        if (ups == settle + 1) {
+            start = t;
+            error_max = error_min = error;
+        } else if (ups > settle + 1 && measured < cycles) {
+            end = t;
+            measured++;
+        }
+    } else if (output > 0 && error < -hysteresis) {
+        output = -relay;
+    }
+
+    if (ups > settle && measured < cycles) {
+        if (error > error_max) error_max = error;
+        if (error < error_min) error_min = error;
+    }
+    return output;
+}
+
+RelayResult RelayExperiment::result() const {
+    RelayResult out = {};
+    double a = (error_max - error_min) / 2;
+    if (!done() || a <= hysteresis) return out;
+
+    // Describing function of a relay with hysteresis
+    out.amplitude = a;
+    out.ku = 4 * relay / (M_PI * std::sqrt(a * a - hysteresis * hysteresis));
+    out.tu = (end - start) / cycles;
+    out.ok = true;
+    return out;
+}
+
+const char* tune_rule_name(TuneRule rule) {
+    switch (rule) {
+        case TuneRule::CLASSIC:
+            return "classic";
+        case TuneRule::SOME_OVERSHOOT:
+            return "some overshoot";
+        default:
+            return "no overshoot";
+    }
+}
+
+TunedGains relay_gains(const RelayResult& result, TuneRule rule, double dt) {
+    // Kp, Ti and Td as fractions of Ku and Tu
+    double p, ti, td;
+    switch (rule) {
+        case TuneRule::CLASSIC:
+            p = 0.6, ti = 0.5, td = 0.125;
+            break;
+        case TuneRule::SOME_OVERSHOOT:
+            p = 0.33, ti = 0.5, td = 0.33;
+            break;
+        default:
+            p = 0.2, ti = 0.5, td = 0.33;
+            break;
+    }
+    double kp = p * result.ku;
+    double ki = kp / (ti * result.tu);
+    double kd = kp * td * result.tu;
+    return {kp, ki * dt, kd / dt};
+}
@@ -0,0 +1,126 @@
+#include "main.h"
+#include "organiz/relocalize.h"
+
+struct RelocSensor {
+    pros::Distance* device;
+    RangeMount mount;
+    uint32_t last_read;
+};
+
+static RelocSensor sensors[RELOC_SENSORS_MAX];
+static int sensor_count = 0;
+
+static FieldSegment field_map[RELOC_SEGMENTS_MAX];
+static int field_map_count = 0;
+// The map the corrector uses, map or its mirror
+static FieldSegment active[RELOC_SEGMENTS_MAX];
+static int active_count = 0;
+
+static std::atomic<bool> on{false};
+static std::atomic<uint32_t> latency{RELOC_LATENCY};
+static std::atomic<int> used{0}, rejected{0};
+
+// Poses of the last few odom steps, to check readings against where the robot was
+struct PastPose {
+    uint32_t time;
+    double x, y, theta;
+};
+static const int HISTORY = 16; // 80 ms at ODOM_PERIOD
+static PastPose history[HISTORY];
+static int history_next = 0;
+static int history_count = 0;
+
+// The newest pose at or before time, nullptr if the history doesn't go back
+// that far yet
+static const PastPose* pose_at(uint32_t time) {
+    for (int i = 1; i <= history_count; i++) {
+        const PastPose& p = history[(history_next - i + HISTORY) % HISTORY];
+        if (p.time <= time) return &p;
+    }
+    return nullptr;
+}
+
+static void corrector(PoseEkf& ekf, const DriveSnapshot& snap) {
+    history[history_next] = {snap.time, ekf.x(), ekf.y(), ekf.theta()};
+    history_next = (history_next + 1) % HISTORY;
+    if (history_count < HISTORY) history_count++;
+    if (!on) return;
+
+    for (int i = 0; i < sensor_count; i++) {
+        RelocSensor& s = sensors[i];
+        if (snap.time - s.last_read < RELOC_PERIOD) continue;
+        // Nothing to check a reading against until the history covers it
+        uint32_t age = latency;
+        const PastPose* then = snap.time >= age ? pose_at(snap.time - age) : nullptr;
+        if (then == nullptr) continue;
+        s.last_read = snap.time;
+
+        // 9999 mm when nothing is in range, confidence only past 200 mm
+        double mm = s.device->get();
+        double reading = mm / 25.4;
+        bool valid = reading >= RELOC_RANGE_MIN && reading <= RELOC_RANGE_MAX &&
+                     (mm < 200 || s.device->get_confidence() >= RELOC_CONFIDENCE_MIN);
+
+        // Carry the reading from when it was taken to now
+        double expected_then = field_ray_cast(then->x, then->y, then->theta, s.mount, active, active_count);
+        double expected_now = ekf.range_expected(s.mount, active, active_count);
+        valid = valid && expected_then > 0 && expected_now > 0;
+
+        if (valid && ekf.update_range(s.mount, reading + expected_now - expected_then, active, active_count))
+            used++;
+        else
+            rejected++;
+    }
+}
+
+void reloc_map_walls(double start_x, double start_y) {
+    // 12 ft field, 140.4 in inside the walls
+    const double h = 70.2;
+    double l = -h - start_x, r = h - start_x, b = -h - start_y, t = h - start_y;
+    reloc_map_add({l, b, r, b});
+    reloc_map_add({r, b, r, t});
+    reloc_map_add({r, t, l, t});
+    reloc_map_add({l, t, l, b});
+}
+
+void reloc_map_add(FieldSegment segment) {
+    if (field_map_count < RELOC_SEGMENTS_MAX) field_map[field_map_count++] = segment;
+}
+
+void reloc_map_clear() {
+    field_map_count = 0;
+}
+
+void reloc_sensor_add(int8_t port, RangeMount mount) {
+    if (sensor_count < RELOC_SENSORS_MAX) sensors[sensor_count++] = {new pros::Distance(port), mount, 0};
+}
+
+void reloc_enable(bool enable, bool mirrored) {
+    if (enable) {
+        on = false;
+        for (int i = 0; i < field_map_count; i++) {
+            active[i] = field_map[i];
+            if (mirrored) {
+                active[i].x1 = -field_map[i].x1;
+                active[i].x2 = -field_map[i].x2;
+            }
+        }
+        active_count = field_map_count;
+        used = rejected = 0;
+        odom_corrector_set(corrector);
+        if (!odom_ekf_enabled()) odom_ekf_enable(true);
+    }
+    on = enable;
+}
+
+bool reloc_enabled() {
+    return on;
+}
+
+void reloc_latency_set(uint32_t ms) {
+    latency = ms;
+}
+
+RelocStats reloc_stats() {
+    return {used, rejected};
+}
@@ -0,0 +1,61 @@
+#include <cmath>
+
+#include "organiz/ring_sort.h"
+
+// How far apart two hues are, going the short way around
+static double hue_distance(double a, double b) {
+    double d = std::fmod(std::fabs(a - b), 360.0);
+    return d > 180 ? 360 - d : d;
+}
+
+RingColor ring_classify(const OpticalSample& sample, const RingClassifier& classifier) {
+    if (sample.proximity < classifier.proximity_min || sample.saturation < classifier.saturation_min)
+        return RingColor::NONE;
+    if (hue_distance(sample.hue, classifier.red_hue) <= classifier.hue_window) return RingColor::RED;
+    if (hue_distance(sample.hue, classifier.blue_hue) <= classifier.hue_window) return RingColor::BLUE;
+    return RingColor::NONE;
+}
+
+RingColor RingDetector::update(RingColor sample) {
+    if (sample == RingColor::NONE) {
+        if (++empty >= release) {
+            counted = false;
+            same = 0;
+        }
+        return RingColor::NONE;
+    }
+    empty = 0;
+    if (counted) return RingColor::NONE;
+
+    same = sample == candidate ? same + 1 : 1;
+    candidate = sample;
+    if (same < confirm) return RingColor::NONE;
+    counted = true;
+    return candidate;
+}
+
+void RingDetector::reset() {
+    candidate = RingColor::NONE;
+    same = empty = 0;
+    counted = false;
+}
+
+bool RingTracker::push(RingColor color, double position) {
+    if (count == CAPACITY) return false;
+    rings[count++] = {color, position};
+    return true;
+}
+
+RingColor RingTracker::update(double position, double lead) {
+    // Oldest ring is first and furthest up the intake
+    while (count > 0 && position < rings[0].seen_at - travel / 4) {
+        for (int i = 1; i < count; i++) rings[i - 1] = rings[i];
+        count--;
+    }
+    if (count == 0 || position + lead < rings[0].seen_at + travel) return RingColor::NONE;
+
+    RingColor color = rings[0].color;
+    for (int i = 1; i < count; i++) rings[i - 1] = rings[i];
+    count--;
+    return color;
+}
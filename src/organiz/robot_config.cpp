@@ -6,8 +6,8 @@
 ez::Drive chassis(
     // These are your drive motors, the first motor is used for sensing! 
     //BACK TO FRONT
-    {-11, -16, -13},     // Left Chassis Ports (negative port will reverse it!)
-    {12, 17, 14},  // Right Chassis Ports (negative port will reverse it!)
+    DRIVE_LEFT_PORTS,     // Left Chassis Ports (negative port will reverse it!)
+    DRIVE_RIGHT_PORTS,  // Right Chassis Ports (negative port will reverse it!)
 
     18,      // IMU Port
     3.25,  // Wheel Diameter (Remember, 4" wheels without screw holes are actually 4.125!)
@@ -21,6 +21,9 @@ ez::Drive chassis(
     17 // Right Rotation Port (negative port will reverse it!)
 );  
 
+// Same motors as chassis, read and written in batches by our own loops
+DriveIO drive_io;
+
 using namespace okapi;
 
 auto leftencoder = RotationSensor(8, true);
@@ -0,0 +1,81 @@
+#include "main.h"
+#include "organiz/routine.h"
+#include "organiz/profiled_drive.h"
+#include "organiz/settle.h"
+
+static bool chaining = true;
+
+void routine_chaining_set(bool on) { chaining = on; }
+bool routine_chaining_get() { return chaining; }
+
+void routine_run(const Step* steps, size_t count) {
+    bool moving = false; // last motion handed off without stopping
+    for (size_t i = 0; i < count; i++) {
+        const Step& s = steps[i];
+        bool slew = s.slew && !moving;
+        switch (s.type) {
+            case StepType::ANGLE:
+                chassis.drive_angle_set(s.value);
+                break;
+            case StepType::DRIVE:
+                if (s.profiled && drive_profile_characterized()) {
+                    drive_profiled(s.value, s.speed);
+                } else if (slew) {
+                    chassis.pid_drive_set(s.value, s.speed, true);
+                } else {
+                    chassis.pid_drive_set(s.value, s.speed);
+                }
+                break;
+            case StepType::TURN:
+                if (slew) {
+                    chassis.pid_turn_set(s.value, s.speed, true);
+                } else {
+                    chassis.pid_turn_set(s.value, s.speed);
+                }
+                break;
+            case StepType::SWING: {
+                ez::e_swing side = s.side == StepSide::LEFT ? ez::LEFT_SWING : ez::RIGHT_SWING;
+                chassis.pid_swing_set(side, s.value, s.speed, s.opposite_speed, slew);
+                break;
+            }
+            case StepType::WAIT:
+                pid_wait_settle();
+                break;
+            case StepType::DELAY:
+                pros::delay(s.value);
+                break;
+            case StepType::INTAKE:
+                intake_set(s.value);
+                break;
+            case StepType::INTAKE_STOP:
+                intake_set(0);
+                break;
+            case StepType::CLAMP:
+                backClamp.set(s.value != 0);
+                break;
+            case StepType::DOINKER:
+                doinker.set(s.value != 0);
+                break;
+            case StepType::RELOCALIZE:
+                reloc_enable(s.value != 0, s.value < 0);
+                break;
+            case StepType::COLOR_SORT:
+                color_sort_set(s.value < 0 ? RingColor::RED : s.value > 0 ? RingColor::BLUE : RingColor::NONE);
+                break;
+        }
+
+        if (s.wait) {
+            StepExit exit = chaining ? s.exit : StepExit::SETTLE;
+            if (exit == StepExit::CHAIN) {
+                chassis.pid_wait_quick_chain();
+            } else if (exit == StepExit::QUICK) {
+                chassis.pid_wait_quick();
+            } else {
+                pid_wait_settle();
+            }
+            moving = exit != StepExit::SETTLE;
+        } else if (step_is_motion(s)) {
+            moving = false;
+        }
+    }
+}
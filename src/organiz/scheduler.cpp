@@ -0,0 +1,81 @@
+#include "main.h"
+#include "organiz/scheduler.h"
+
+// Every timer registers here so loop_stats_print() can find it. Most are
+// statics, so this runs before main() and can't print.
+static LoopTimer* loops[LOOP_TIMERS_MAX];
+static int loop_count = 0;
+static int loops_unlisted = 0;
+
+LoopTimer::LoopTimer(const char* name, uint32_t period_ms) : name(name), period(period_ms) {
+    if (loop_count < LOOP_TIMERS_MAX) {
+        loops[loop_count++] = this;
+    } else {
+        loops_unlisted++;
+    }
+}
+
+void LoopTimer::wait() {
+    uint64_t now = pros::micros();
+    if (!started) {
+        // First pass, there's no previous release to measure against
+        started = true;
+        release_ms = now / 1000;
+    } else {
+        uint32_t work = now - wake_us;
+        if (work > loop_stats.max_work_us) loop_stats.max_work_us = work;
+    }
+
+    // Finished after the next release, so that deadline is already gone.
+    // Re-anchor to now instead of letting delay_until burst to catch up.
+    if (now > (uint64_t)(release_ms + period) * 1000) {
+        loop_stats.deadline_misses++;
+        release_ms = now / 1000;
+    }
+
+    pros::Task::delay_until(&release_ms, period);
+
+    wake_us = pros::micros();
+    uint64_t release_us = (uint64_t)release_ms * 1000;
+    uint32_t jitter = wake_us > release_us ? wake_us - release_us : 0;
+    if (jitter > loop_stats.max_jitter_us) loop_stats.max_jitter_us = jitter;
+    loop_stats.iterations++;
+    loop_stats.avg_jitter_us += (jitter - loop_stats.avg_jitter_us) / loop_stats.iterations;
+}
+
+void LoopTimer::stats_reset() {
+    loop_stats = LoopStats();
+    started = false;
+}
+
+PeriodicLoop::PeriodicLoop(const char* name, uint32_t period_ms, std::function<void()> body, uint32_t priority)
+    : timer(name, period_ms), body(body), priority(priority) {}
+
+void PeriodicLoop::start() {
+    is_running = true;
+    if (task == nullptr) {
+        task = new pros::Task([this] {
+            while (true) {
+                if (is_running) {
+                    this->body();
+                }
+                timer.wait();
+            }
+        }, priority, TASK_STACK_DEPTH_DEFAULT, timer.name_get());
+    }
+}
+
+void PeriodicLoop::pause() {
+    is_running = false;
+}
+
+void loop_stats_print() {
+    for (int i = 0; i < loop_count; i++) {
+        const LoopStats& s = loops[i]->stats();
+        printf("%-12s %3lums  iter %lu  miss %lu  jitter avg %.0fus max %luus  work max %luus\n",
+               loops[i]->name_get(), (unsigned long)loops[i]->period_get(), (unsigned long)s.iterations,
+               (unsigned long)s.deadline_misses, s.avg_jitter_us, (unsigned long)s.max_jitter_us,
+               (unsigned long)s.max_work_us);
+    }
+    if (loops_unlisted > 0) printf("%d more loops not listed, raise LOOP_TIMERS_MAX\n", loops_unlisted);
+}
@@ -0,0 +1,146 @@
+#include "main.h"
+#include "organiz/settle.h"
+
+static SettleMode settle_mode = SettleMode::TIMERS;
+static double settle_horizon = 0.1;
+
+static const int SETTLE_LOG = 16;
+static MotionSettle settle_log[SETTLE_LOG];
+static int settle_count = 0; // motions since the reset, the log keeps the last SETTLE_LOG
+static SettleStats stats = {};
+
+void settle_mode_set(SettleMode mode) { settle_mode = mode; }
+SettleMode settle_mode_get() { return settle_mode; }
+void settle_horizon_set(double horizon) { settle_horizon = horizon; }
+double settle_horizon_get() { return settle_horizon; }
+
+static ExitLimits limits_get(const ez::PID& pid) {
+    return {pid.exit.small_exit_time, pid.exit.small_error, pid.exit.big_exit_time,
+            pid.exit.big_error, pid.exit.velocity_exit_time, pid.exit.mA_timeout};
+}
+
+static void settle_record(const MotionSettle& m) {
+    settle_log[settle_count % SETTLE_LOG] = m;
+    settle_count++;
+    stats.motions++;
+    stats.ms += m.ms;
+    if (m.exit == SettleExit::PREDICTED) {
+        stats.predicted++;
+        stats.saved_ms += m.saved_ms;
+        if (std::fabs(m.error) > stats.error_max) stats.error_max = std::fabs(m.error);
+    }
+}
+
+void SettleWait::start() {
+    mode = chassis.drive_mode_get();
+    start_ms = pros::millis();
+    first = true;
+    running = mode == ez::DRIVE || mode == ez::TURN || mode == ez::SWING;
+    if (!running) return;
+
+    ez::PID* pids[2] = {&chassis.leftPID, &chassis.rightPID};
+    if (mode == ez::TURN) pids[0] = &chassis.turnPID;
+    if (mode == ez::SWING) pids[0] = &chassis.swingPID;
+    n = mode == ez::DRIVE ? 2 : 1;
+    for (int i = 0; i < 2; i++) {
+        sides[i] = {pids[i], ExitTimers(limits_get(*pids[i])), SettlePredictor(pids[i]->exit.small_error, settle_horizon),
+                    SettleExit::RUNNING, 0};
+    }
+}
+
+SettleExit SettleWait::update() {
+    if (!running) return SettleExit::SMALL;
+    // The first error EZ computed for the motion, like pid_wait()
+    if (first) {
+        for (int i = 0; i < n; i++) sides[i].prev_error = sides[i].pid->error;
+        first = false;
+    }
+
+    double t = (pros::millis() - start_ms) / 1000.0;
+    bool predicted = settle_mode == SettleMode::PREDICT, timed_out = true;
+    for (int i = 0; i < n; i++) {
+        Side& s = sides[i];
+        double error = s.pid->error;
+        bool over;
+        if (mode == ez::DRIVE) {
+            over = i == 0 ? chassis.drive_current_left_over() : chassis.drive_current_right_over();
+        } else if (mode == ez::TURN) {
+            over = chassis.drive_current_left_over() || chassis.drive_current_right_over();
+        } else {
+            over = chassis.current_swing == ez::LEFT_SWING ? chassis.drive_current_left_over()
+                                                            : chassis.drive_current_right_over();
+        }
+        // A side EZ's timers already let go of stays let go, like pid_wait()
+        if (s.exit == SettleExit::RUNNING) {
+            s.exit = s.timers.update(error, error - s.prev_error, over, ez::util::DELAY_TIME);
+        }
+        predicted = s.predictor.update(error, t) && predicted;
+        timed_out = s.exit != SettleExit::RUNNING && timed_out;
+        s.prev_error = error;
+    }
+
+    MotionSettle m = {mode, 0, 0, SettleExit::RUNNING, 0};
+    if (predicted) {
+        m.exit = SettleExit::PREDICTED;
+        for (int i = 0; i < n; i++) {
+            int left = sides[i].pid->exit.small_exit_time - sides[i].timers.small_ms();
+            if (sides[i].exit == SettleExit::RUNNING && left > m.saved_ms) m.saved_ms = left;
+        }
+    } else if (timed_out) {
+        // Interference on either side wins, like pid_wait()
+        m.exit = sides[0].exit;
+        if (n == 2 && (m.exit == SettleExit::SMALL || m.exit == SettleExit::BIG)) m.exit = sides[1].exit;
+    } else {
+        return SettleExit::RUNNING;
+    }
+
+    chassis.interfered = m.exit == SettleExit::MA || m.exit == SettleExit::VELOCITY;
+    m.ms = pros::millis() - start_ms;
+    for (int i = 0; i < n; i++) m.error += sides[i].pid->error / n;
+    settle_record(m);
+    running = false;
+    return m.exit;
+}
+
+SettleExit pid_wait_settle() {
+    ez::e_mode mode = chassis.drive_mode_get();
+    if (settle_mode == SettleMode::TIMERS || (mode != ez::DRIVE && mode != ez::TURN && mode != ez::SWING)) {
+        uint32_t start = pros::millis();
+        chassis.pid_wait();
+        MotionSettle m = {mode, pros::millis() - start, 0, SettleExit::RUNNING, 0};
+        // EZ only says whether it was interfered with
+        m.exit = chassis.interfered ? SettleExit::VELOCITY : SettleExit::SMALL;
+        ez::PID& pid = mode == ez::DRIVE ? chassis.leftPID : mode == ez::TURN ? chassis.turnPID : chassis.swingPID;
+        m.error = pid.error;
+        settle_record(m);
+        return m.exit;
+    }
+
+    SettleWait wait;
+    wait.start();
+    // Lets EZ's task compute the motion's first error, like pid_wait()
+    pros::delay(ez::util::DELAY_TIME);
+    SettleExit exit;
+    while ((exit = wait.update()) == SettleExit::RUNNING) pros::delay(ez::util::DELAY_TIME);
+    return exit;
+}
+
+SettleStats settle_stats() { return stats; }
+const MotionSettle& settle_last() { return settle_log[(settle_count + SETTLE_LOG - 1) % SETTLE_LOG]; }
+
+void settle_stats_reset() {
+    stats = {};
+    settle_count = 0;
+}
+
+void settle_stats_print() {
+    printf("%d motions, %d predicted, %lu ms waiting, %d ms of small_exit_time skipped, worst predicted error %.2f\n",
+           stats.motions, stats.predicted, (unsigned long)stats.ms, stats.saved_ms, stats.error_max);
+    int first = settle_count > SETTLE_LOG ? settle_count - SETTLE_LOG : 0;
+    for (int i = first; i < settle_count; i++) {
+        const MotionSettle& m = settle_log[i % SETTLE_LOG];
+        const char* mode = m.mode == ez::DRIVE ? "drive" : m.mode == ez::TURN ? "turn" : m.mode == ez::SWING ? "swing" : "-";
+        printf("  %-6s %5lu ms  error %6.2f  %-9s saved %d ms\n", mode, (unsigned long)m.ms, m.error,
+               settle_exit_name(m.exit), m.saved_ms);
+    }
+}
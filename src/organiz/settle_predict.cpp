@@ -0,0 +1,93 @@
+#include <cmath>
+
+#include "organiz/settle_predict.h"
+
+const char* settle_exit_name(SettleExit exit) {
+    switch (exit) {
+        case SettleExit::RUNNING:
+            return "running";
+        case SettleExit::PREDICTED:
+            return "predicted";
+        case SettleExit::SMALL:
+            return "small";
+        case SettleExit::BIG:
+            return "big";
+        case SettleExit::VELOCITY:
+            return "velocity";
+        default:
+            return "mA";
+    }
+}
+
+ExitTimers::ExitTimers(const ExitLimits& limits, double velocity_zero) : limits(limits), velocity_zero(velocity_zero) {}
+
+SettleExit ExitTimers::update(double error, double velocity, bool over_current, int dt) {
+    if (limits.mA_timeout != 0) {
+        current = over_current ? current + dt : 0;
+        if (current > limits.mA_timeout) return SettleExit::MA;
+    }
+
+    // Inside small_error the big timer doesn't run, like EZ
+    if (limits.small_error != 0 && std::fabs(error) < limits.small_error) {
+        small += dt;
+        big = 0;
+        if (small > limits.small_exit_time) return SettleExit::SMALL;
+    } else {
+        small = 0;
+        if (limits.big_error != 0 && limits.big_exit_time != 0) {
+            big = std::fabs(error) < limits.big_error ? big + dt : 0;
+            if (big > limits.big_exit_time) return SettleExit::BIG;
+        }
+    }
+
+    if (limits.velocity_exit_time != 0) {
+        stopped = std::fabs(velocity) <= velocity_zero ? stopped + dt : 0;
+        if (stopped > limits.velocity_exit_time) return SettleExit::VELOCITY;
+    }
+    return SettleExit::RUNNING;
+}
+
+SettlePredictor::SettlePredictor(double tolerance, double horizon) : tolerance(tolerance), horizon(horizon) {}
+
+bool SettlePredictor::update(double error, double t) {
+    errors[count % WINDOW] = error;
+    times[count % WINDOW] = t;
+    count++;
+    int n = count < WINDOW ? count : WINDOW;
+
+    // Least squares line through the window, about its mean time
+    double t_mean = 0, e_mean = 0;
+    for (int i = 0; i < n; i++) {
+        t_mean += times[i];
+        e_mean += errors[i];
+    }
+    t_mean /= n;
+    e_mean /= n;
+    double tt = 0, te = 0;
+    for (int i = 0; i < n; i++) {
+        tt += (times[i] - t_mean) * (times[i] - t_mean);
+        te += (times[i] - t_mean) * (errors[i] - e_mean);
+    }
+    fit_velocity = tt > 0 ? te / tt : 0;
+    fit_error = e_mean + fit_velocity * (t - t_mean);
+    double sse = 0;
+    for (int i = 0; i < n; i++) {
+        double r = errors[i] - (e_mean + fit_velocity * (times[i] - t_mean));
+        sse += r * r;
+    }
+    fit_rms = std::sqrt(sse / n);
+
+    // Inside now and still inside a horizon from now, slow, and a straight
+    // enough line that the fit can be trusted
+    if (n < WINDOW) return false;
+    return std::fabs(fit_error) < tolerance && std::fabs(fit_error + fit_velocity * horizon) < tolerance &&
+           std::fabs(fit_velocity) * horizon < tolerance / 2 && fit_rms < tolerance / 2;
+}
+
+double SettlePredictor::time_to_settle() const {
+    double e = std::fabs(fit_error);
+    if (e < tolerance) return 0;
+    // Closing when the error and its velocity have opposite signs
+    if (fit_error * fit_velocity >= 0) return -1;
+    return (e - tolerance) / std::fabs(fit_velocity);
+}
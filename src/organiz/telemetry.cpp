@@ -0,0 +1,134 @@
+#include "main.h"
+#include "organiz/telemetry.h"
+#include "organiz/ring_buffer.h"
+
+// 256 ticks is 2.5 s of slack if the SD card stalls
+static RingBuffer<TelemetrySample, 256> samples;
+static FILE* file = nullptr;
+static pros::Mutex file_mutex;
+
+// Control side: a handful of reads and one push, no I/O
+static void capture() {
+    TelemetrySample s;
+    DriveSnapshot snap;
+    drive_io.read(snap);
+    DriveHealth health;
+    drive_io.health_read(health);
+    ez::pose pose = chassis.odom_pose_get();
+
+    s.time_ms = snap.time;
+    s.mode = chassis.drive_mode_get();
+    s.flags = chassis.interfered ? TELEMETRY_INTERFERED : 0;
+    s.reserved = 0;
+    s.target_left = chassis.leftPID.target;
+    s.target_right = chassis.rightPID.target;
+    s.target_heading = chassis.headingPID.target;
+    s.x = pose.x;
+    s.y = pose.y;
+    s.theta = pose.theta;
+    s.sensor_left = snap.left;
+    s.sensor_right = snap.right;
+    s.imu = snap.imu;
+    s.mA_left = health.left_current;
+    s.mA_right = health.right_current;
+    s.out_left = chassis.leftPID.output;
+    s.out_right = chassis.rightPID.output;
+    s.out_turn = chassis.turnPID.output;
+    s.out_swing = chassis.swingPID.output;
+    s.out_heading = chassis.headingPID.output;
+
+    samples.push(s);
+}
+
+// SD side: drains the buffer in batches
+static void drain() {
+    static TelemetrySample batch[64];
+    file_mutex.take();
+    if (file != nullptr) {
+        size_t n;
+        while ((n = samples.pop(batch, 64)) > 0) {
+            fwrite(batch, sizeof(TelemetrySample), n, file);
+        }
+        fflush(file);
+    }
+    file_mutex.give();
+}
+
+static PeriodicLoop capture_loop("telemetry", ez::util::DELAY_TIME, capture, TASK_PRIORITY_DEFAULT + 1);
+static PeriodicLoop writer_loop("tlm writer", 250, drain, TASK_PRIORITY_MIN + 1);
+
+// Next free tlm_NNN.bin into name, reusing the last one if nothing was
+// recorded into it. False once all 1000 are taken.
+static bool name_pick(char* name, size_t size) {
+    for (int i = 0; i < 1000; i++) {
+        snprintf(name, size, "/usd/tlm_%03d.bin", i);
+        FILE* existing = fopen(name, "r");
+        if (existing == nullptr) {
+            if (i == 0) return true;
+            snprintf(name, size, "/usd/tlm_%03d.bin", i - 1);
+            FILE* last = fopen(name, "r");
+            fseek(last, 0, SEEK_END);
+            bool empty = ftell(last) <= (long)sizeof(TelemetryHeader);
+            fclose(last);
+            if (!empty) snprintf(name, size, "/usd/tlm_%03d.bin", i);
+            return true;
+        }
+        fclose(existing);
+    }
+    return false;
+}
+
+void telemetry_open() {
+    if (!ez::util::SD_CARD_ACTIVE || file != nullptr) return;
+
+    char name[24];
+    if (!name_pick(name, sizeof(name))) return;
+    FILE* f = fopen(name, "wb");
+    if (f == nullptr) return;
+    TelemetryHeader header = {TELEMETRY_MAGIC, TELEMETRY_VERSION, sizeof(TelemetrySample)};
+    fwrite(&header, sizeof(header), 1, f);
+    fflush(f);
+
+    file_mutex.take();
+    file = f;
+    file_mutex.give();
+}
+
+void telemetry_start() {
+    if (file == nullptr || telemetry_recording()) return;
+
+    // Throw away anything left from a previous recording
+    static TelemetrySample discard[64];
+    while (samples.pop(discard, 64) > 0) {}
+
+    // printf from the control task stalls it, the recording replaces it
+    chassis.pid_print_toggle(false);
+
+    capture_loop.start();
+    writer_loop.start();
+}
+
+void telemetry_stop() {
+    if (!telemetry_recording()) return;
+
+    capture_loop.pause();
+    pros::delay(ez::util::DELAY_TIME); // let an in-flight capture finish
+    writer_loop.pause();
+    drain();
+
+    file_mutex.take();
+    fclose(file);
+    file = nullptr;
+    file_mutex.give();
+
+    if (samples.dropped() > 0) {
+        printf("telemetry: dropped %lu samples\n", (unsigned long)samples.dropped());
+    }
+
+    // Ready for an auton run from opcontrol
+    telemetry_open();
+}
+
+bool telemetry_recording() {
+    return capture_loop.running();
+}
@@ -1,5 +1,7 @@
 #include <cmath>
 #include "main.h"
+#include "organiz/odom_math.h"
+#include "organiz/path_follower.h"
 
 
 class PIDController {
@@ -87,8 +89,10 @@ public:
         
         double delta_distance = (delta_left_pos + delta_right_pos) / 2.0;
         
-        double delta_x = delta_distance * cos(prev_heading * M_PI / 180.0);
-        double delta_y = delta_distance * sin(prev_heading * M_PI / 180.0);
+        // Move along the arc of the step, not the heading at its start
+        OdomStep step = odom_step(OdomIntegrator::ARC, delta_distance, delta_heading * M_PI / 180.0);
+        double delta_x = step.length * cos(prev_heading * M_PI / 180.0 + step.angle);
+        double delta_y = step.length * sin(prev_heading * M_PI / 180.0 + step.angle);
         
         start_x_position += delta_x;
         start_y_position += delta_y;
@@ -141,6 +145,7 @@ private:
     PIDController pid_controller_right;
     
     std::vector<Point> path; // List of points to follow
+    PathCursor<Point> cursor; // Closest and lookahead points, only move forward
     double lookahead_distance; // Distance to look ahead on the path
     double max_velocity; // Maximum velocity of the robot
     double max_acceleration; // Maximum acceleration of the robot
@@ -153,8 +158,10 @@ public:
     Drivetrain(Odometry odometry, PIDController pid_left, PIDController pid_right, double lookahead_dist, double max_vel, double max_acc, double width) 
         : odometry(odometry), pid_controller_left(pid_left), pid_controller_right(pid_right), lookahead_distance(lookahead_dist), max_velocity(max_vel), max_acceleration(max_acc), current_left_velocity(0), current_right_velocity(0), wheelbase_width(width) {}
     
+    // Every new path goes through here, so the cursor starts over on it
     void setPath(std::vector<Point> waypoints) {
         path = waypoints;
+        cursor.reset(path.data(), path.size());
     }
 
     double adjustVelocity(double current_velocity, double target_velocity, double distance_remaining) {
@@ -166,36 +173,21 @@ public:
             return std::max(current_velocity - acceleration_clamped, target_velocity);
         }
     }
-    //updated followpath
-    void followPath(std::vector<Point> path) {
+    //updated followpath, along the path from setPath()
+    void followPath() {
     Point current_pose = {odometry.getX(), odometry.getY(), odometry.getHeading()};
     
-    // Find the index of the closest point on the path
-    int closest_index = 0;
-    double closest_distance = std::numeric_limits<double>::max();
-    for (int i = 0; i < path.size(); ++i) {
-        double distance = std::hypot(path[i].x - current_pose.x, path[i].y - current_pose.y);
-        if (distance < closest_distance) {
-            closest_distance = distance;
-            closest_index = i;
-        }
-    }
+    // Closest point, searched in a window ahead of last tick's
+    cursor.closest(current_pose.x, current_pose.y);
     
-    // Find the lookahead point
-    int lookahead_index = closest_index;
-    double lookahead_distance_squared = lookahead_distance * lookahead_distance;
-    while (lookahead_index < path.size() - 1) {
-        double dx = path[lookahead_index + 1].x - current_pose.x;
-        double dy = path[lookahead_index + 1].y - current_pose.y;
-        double distance_squared = dx * dx + dy * dy;
-        if (distance_squared > lookahead_distance_squared) {
-            break;
-        }
-        lookahead_index++;
+    // Lookahead point, where the lookahead circle crosses the path
+    double lookahead_x, lookahead_y;
+    if (!cursor.lookahead(current_pose.x, current_pose.y, lookahead_distance, lookahead_x, lookahead_y)) {
+        return; // no path set
     }
     
     // Calculate the desired heading angle
-    double desired_heading = std::atan2(path[lookahead_index].y - current_pose.y, path[lookahead_index].x - current_pose.x);
+    double desired_heading = std::atan2(lookahead_y - current_pose.y, lookahead_x - current_pose.x);
     
     // Calculate the curvature
     double curvature = 2 * std::sin(desired_heading - odometry.getHeading()) / lookahead_distance;
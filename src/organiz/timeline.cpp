@@ -0,0 +1,213 @@
+#include "main.h"
+#include "organiz/timeline.h"
+#include "organiz/profiled_drive.h"
+#include "organiz/settle.h"
+
+enum class NodeState : uint8_t { WAITING, RUNNING, DONE };
+
+struct NodeRun {
+    NodeState state;
+    uint32_t start;
+    uint32_t end;
+};
+
+static LoopTimer timer("timeline", ez::util::DELAY_TIME);
+
+// The chassis runs one motion at a time: its profile, then EZ until it
+// settles, or until it crosses the target for a chained exit
+static int motion_node = -1;
+static ProfiledMotion profiled;
+static SettleWait settle;
+static StepExit motion_exit = StepExit::SETTLE;
+static double motion_chain = 0; // how far past the target EZ is aiming
+static int motion_sign = 0;     // of what was left at the start
+
+// Left to go on the running motion to its own target, in or deg
+static double motion_remaining() {
+    if (profiled.active()) return profiled.remaining();
+    ez::e_mode mode = chassis.drive_mode_get();
+    double error = chassis.swingPID.error;
+    if (mode == ez::DRIVE) error = (chassis.leftPID.error + chassis.rightPID.error) / 2;
+    if (mode == ez::TURN) error = chassis.turnPID.error;
+    return error - motion_chain;
+}
+
+// Like pid_wait_quick_chain(), aims EZ's motion past its target
+static void motion_chain_set(const Step& s) {
+    int sign = s.type == StepType::DRIVE ? ez::util::sgn(s.value) : ez::util::sgn(s.value - chassis.drive_imu_get());
+    if (s.type == StepType::DRIVE) {
+        motion_chain = sign * (sign > 0 ? chassis.pid_drive_chain_forward_constant_get()
+                                        : chassis.pid_drive_chain_backward_constant_get());
+        chassis.leftPID.target_set(chassis.leftPID.target_get() + motion_chain);
+        chassis.rightPID.target_set(chassis.rightPID.target_get() + motion_chain);
+    } else if (s.type == StepType::TURN) {
+        motion_chain = sign * chassis.pid_turn_chain_constant_get();
+        chassis.turnPID.target_set(chassis.turnPID.target_get() + motion_chain);
+    } else {
+        motion_chain = sign * (sign > 0 ? chassis.pid_swing_chain_forward_constant_get()
+                                        : chassis.pid_swing_chain_backward_constant_get());
+        chassis.swingPID.target_set(chassis.swingPID.target_get() + motion_chain);
+    }
+}
+
+static void motion_start(const Step& s, bool moving) {
+    motion_exit = s.exit;
+    motion_chain = 0;
+    motion_sign = 0; // taken on the first tick, once EZ has computed an error
+    bool slew = s.slew && !moving;
+    ez::e_swing side = s.side == StepSide::LEFT ? ez::LEFT_SWING : ez::RIGHT_SWING;
+    if (s.profiled && drive_profile_characterized()) {
+        if (s.type == StepType::DRIVE) {
+            profiled.drive(s.value, s.speed);
+        } else if (s.type == StepType::TURN) {
+            profiled.turn(s.value, s.speed);
+        } else {
+            profiled.swing(side, s.value, s.speed);
+        }
+        // The first tick plays now like drive_profiled(), a profile that's
+        // already over has handed off to EZ
+        if (!profiled.update()) settle.start();
+        return;
+    }
+    // EZ takes the motion from here, a profile it cut short stops
+    profiled = ProfiledMotion();
+    if (s.type == StepType::DRIVE) {
+        if (slew) {
+            chassis.pid_drive_set(s.value, s.speed, true);
+        } else {
+            chassis.pid_drive_set(s.value, s.speed);
+        }
+    } else if (s.type == StepType::TURN) {
+        if (slew) {
+            chassis.pid_turn_set(s.value, s.speed, true);
+        } else {
+            chassis.pid_turn_set(s.value, s.speed);
+        }
+    } else {
+        chassis.pid_swing_set(side, s.value, s.speed, s.opposite_speed, slew);
+    }
+    if (s.exit == StepExit::CHAIN) motion_chain_set(s);
+    settle.start();
+}
+
+// Mechanism steps, undo puts back what a for_ms() node did
+static void mechanism_set(const Step& s, bool undo) {
+    switch (s.type) {
+        case StepType::ANGLE:
+            chassis.drive_angle_set(s.value);
+            break;
+        case StepType::INTAKE:
+            intake_set(undo ? 0 : s.value);
+            break;
+        case StepType::INTAKE_STOP:
+            intake_set(0);
+            break;
+        case StepType::CLAMP:
+            backClamp.set((s.value != 0) != undo);
+            break;
+        case StepType::DOINKER:
+            doinker.set((s.value != 0) != undo);
+            break;
+        case StepType::RELOCALIZE:
+            reloc_enable((s.value != 0) != undo, s.value < 0);
+            break;
+        case StepType::COLOR_SORT:
+            color_sort_set(undo || s.value == 0 ? RingColor::NONE : s.value < 0 ? RingColor::RED : RingColor::BLUE);
+            break;
+        default:
+            break;
+    }
+}
+
+void timeline_run(const Node* nodes, size_t count) {
+    NodeRun run[TIMELINE_MAX] = {};
+    if (count > TIMELINE_MAX) count = TIMELINE_MAX;
+    uint32_t t0 = pros::millis();
+    motion_node = -1;
+    timer.stats_reset();
+
+    while (true) {
+        uint32_t now = pros::millis();
+
+        // The running motion: its profile hands off to EZ, then the wait. A
+        // chained one is done once it's past its target, still moving.
+        bool moving = false;
+        if (motion_node >= 0) {
+            bool done = false;
+            if (motion_exit != StepExit::SETTLE) {
+                double left = motion_remaining();
+                if (motion_sign == 0) motion_sign = ez::util::sgn(left);
+                moving = done = ez::util::sgn(left) != motion_sign;
+            }
+            if (profiled.active()) {
+                if (!done && !profiled.update()) settle.start();
+            } else if (!done) {
+                done = settle.update() != SettleExit::RUNNING;
+            }
+            if (done) {
+                run[motion_node] = {NodeState::DONE, run[motion_node].start, now};
+                motion_node = -1;
+            }
+        }
+
+        bool done = true;
+        for (size_t i = 0; i < count; i++) {
+            const Node& n = nodes[i];
+            NodeRun& r = run[i];
+
+            if (r.state == NodeState::WAITING) {
+                bool ready;
+                if (n.back > i) {
+                    ready = now >= t0 + n.value;
+                } else {
+                    int dep = i - n.back;
+                    const NodeRun& d = run[dep];
+                    if (n.start == NodeStart::AFTER) {
+                        ready = d.state == NodeState::DONE && now >= d.end + n.value;
+                    } else if (n.start == NodeStart::WITH) {
+                        ready = d.state != NodeState::WAITING && now >= d.start + n.value;
+                    } else {
+                        ready = d.state == NodeState::DONE ||
+                                (d.state == NodeState::RUNNING && motion_node == dep && std::fabs(motion_remaining()) < n.value);
+                    }
+                }
+                if (!ready) {
+                    done = false;
+                    continue;
+                }
+
+                r = {NodeState::RUNNING, now, now};
+                if (step_is_motion(n.step)) {
+                    // A new motion takes the chassis, the one it cut short is done
+                    if (motion_node >= 0) {
+                        run[motion_node] = {NodeState::DONE, run[motion_node].start, now};
+                        moving = true;
+                    }
+                    motion_node = i;
+                    motion_start(n.step, moving);
+                    moving = false;
+                } else if (n.step.type != StepType::DELAY && n.step.type != StepType::WAIT) {
+                    mechanism_set(n.step, false);
+                    if (n.duration == 0) r.state = NodeState::DONE;
+                }
+            }
+
+            if (r.state == NodeState::RUNNING && (int)i != motion_node) {
+                bool finished;
+                if (n.step.type == StepType::DELAY) {
+                    finished = now >= r.start + n.step.value;
+                } else if (n.step.type == StepType::WAIT) {
+                    finished = motion_node < 0;
+                } else {
+                    finished = now >= r.start + n.duration;
+                    if (finished) mechanism_set(n.step, true);
+                }
+                if (finished) r = {NodeState::DONE, r.start, now};
+            }
+            if (r.state != NodeState::DONE) done = false;
+        }
+
+        if (done) break;
+        timer.wait();
+    }
+}